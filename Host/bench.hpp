@@ -0,0 +1,61 @@
+#ifndef BENCH_HPP
+#define BENCH_HPP
+
+#include "hwlib.hpp"
+#include <cstdint>
+#include <cstdio>
+
+////////////////////////////////////////////////////////////////////////
+
+// an spi bus that only counts the bytes, so a benchmark times the library
+// and not the controller model
+class counting_bus : public hwlib::spi_bus {
+private:
+    size_t byte_count = 0;
+
+public:
+    void write_and_read(const size_t n, const uint8_t data_out[], uint8_t data_in[]) override {
+        if(data_in != nullptr){
+            for(size_t i = 0; i < n; i++){
+                data_in[i] = 0;
+            }
+        }
+        byte_count += n;
+    }
+
+    size_t bytes() const {
+        return byte_count;
+    }
+
+    void clear_count(){
+        byte_count = 0;
+    }
+}; // class counting_bus
+
+// the time in us of n calls of f
+template< typename F >
+uint_fast64_t time_us(int n, F f){
+    auto start = hwlib::now_us();
+    for(int i = 0; i < n; i++){
+        f();
+    }
+    auto time = hwlib::now_us() - start;
+    return time > 0 ? time : 1;
+}
+
+// bytes per second of the Due hardware SPI at 21 MHz, the bus limit a
+// host rate is compared against
+constexpr uint32_t due_spi_bytes_per_s = 21000000 / 8;
+
+////////////////////////////////////////////////////////////////////////
+
+// the benchmarks, run with "host bench"
+void bench_raster();
+void bench_rgb565();
+void bench_rle();
+void bench_sprite();
+void bench_tiles();
+
+////////////////////////////////////////////////////////////////////////
+
+#endif //BENCH_HPP
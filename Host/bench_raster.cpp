@@ -0,0 +1,109 @@
+#include "bench.hpp"
+#include "ILI9163.hpp"
+#include "ILI9163_raster.hpp"
+#include "ILI9163_simulator.hpp"
+
+// SPI bytes per shape of the span rasterizers against hwlib::line,
+// hwlib::circle and hwlib::rectangle drawn through the direct window,
+// with the snake shapes first: a 5x5 segment, a food circle and a wall line.
+// hwlib has no filled triangle or rounded rectangle, those are drawn one
+// hwlib write per pixel, the pixels the spans give
+
+////////////////////////////////////////////////////////////////////////
+
+static ILI9163_simulator chip;
+static ILI9163_simulator_bus bus(chip);
+
+static size_t bytes_of(void (* draw)(ILI9163_display & display), ILI9163_display & display){
+    bus.clear_count();
+    draw(display);
+    return bus.bytes();
+}
+
+struct shape {
+    const char * name;
+    void (* span)(ILI9163_display & display);
+    void (* pixels)(ILI9163_display & display);
+};
+
+static const uint16_t ink = 0xf800;
+static const hwlib::color ink_color(0, 0, 255);
+
+static ILI9163_simulator scratch_chip;
+static ILI9163_simulator_bus scratch_bus(scratch_chip);
+
+// the pixels that span draws, written one at a time with hwlib
+static void pixels_of(void (* span)(ILI9163_display & display), ILI9163_display & d){
+    ILI9163_display scratch(scratch_bus, hwlib::pin_out_dummy, scratch_bus.wrx(), hwlib::pin_out_dummy);
+    scratch.clear(hwlib::white);
+    span(scratch);
+    for(int y = 0; y < 129; y++){
+        for(int x = 0; x < 130; x++){
+            if(scratch_chip.pixel(hwlib::xy(x, y)) == ink){
+                d.write(hwlib::xy(x, y), ink_color);
+            }
+        }
+    }
+}
+
+static void triangle(ILI9163_display & d){
+    ILI9163_fill_triangle(d, hwlib::xy(10, 10), hwlib::xy(120, 40), hwlib::xy(40, 120), ink);
+}
+
+static void button(ILI9163_display & d){
+    ILI9163_fill_round_rect(d, hwlib::xy(20, 50), hwlib::xy(90, 24), 6, ink);
+}
+
+static void pill(ILI9163_display & d){
+    ILI9163_fill_round_rect(d, hwlib::xy(10, 60), hwlib::xy(110, 10), 100, ink);
+}
+
+static const shape shapes[] = {
+    { "segment 5x5",
+      [](ILI9163_display & d){
+          ILI9163_hline(d, 40, 44, 40, ink); ILI9163_hline(d, 40, 44, 44, ink);
+          ILI9163_vline(d, 40, 41, 43, ink); ILI9163_vline(d, 44, 41, 43, ink); },
+      [](ILI9163_display & d){ hwlib::rectangle(hwlib::xy(40, 40), hwlib::xy(44, 44), ink_color).draw(d); } },
+    { "food r=3",
+      [](ILI9163_display & d){ ILI9163_circle(d, hwlib::xy(60, 60), 3, ink); },
+      [](ILI9163_display & d){ hwlib::circle(hwlib::xy(60, 60), 3, ink_color).draw(d); } },
+    { "wall 130x1",
+      [](ILI9163_display & d){ ILI9163_line(d, hwlib::xy(0, 8), hwlib::xy(129, 8), ink); },
+      [](ILI9163_display & d){ hwlib::line(hwlib::xy(0, 8), hwlib::xy(129, 8), ink_color).draw(d); } },
+    { "line 1:1",
+      [](ILI9163_display & d){ ILI9163_line(d, hwlib::xy(0, 0), hwlib::xy(128, 128), ink); },
+      [](ILI9163_display & d){ hwlib::line(hwlib::xy(0, 0), hwlib::xy(128, 128), ink_color).draw(d); } },
+    { "line 1:4",
+      [](ILI9163_display & d){ ILI9163_line(d, hwlib::xy(0, 30), hwlib::xy(128, 62), ink); },
+      [](ILI9163_display & d){ hwlib::line(hwlib::xy(0, 30), hwlib::xy(128, 62), ink_color).draw(d); } },
+    { "vertical",
+      [](ILI9163_display & d){ ILI9163_line(d, hwlib::xy(70, 0), hwlib::xy(70, 128), ink); },
+      [](ILI9163_display & d){ hwlib::line(hwlib::xy(70, 0), hwlib::xy(70, 128), ink_color).draw(d); } },
+    { "circle r=20",
+      [](ILI9163_display & d){ ILI9163_circle(d, hwlib::xy(64, 64), 20, ink); },
+      [](ILI9163_display & d){ hwlib::circle(hwlib::xy(64, 64), 20, ink_color).draw(d); } },
+    { "circle r=60",
+      [](ILI9163_display & d){ ILI9163_circle(d, hwlib::xy(64, 64), 60, ink); },
+      [](ILI9163_display & d){ hwlib::circle(hwlib::xy(64, 64), 60, ink_color).draw(d); } },
+    { "triangle",
+      triangle,
+      [](ILI9163_display & d){ pixels_of(triangle, d); } },
+    { "button 90x24",
+      button,
+      [](ILI9163_display & d){ pixels_of(button, d); } },
+    { "pill 110x10",
+      pill,
+      [](ILI9163_display & d){ pixels_of(pill, d); } },
+};
+
+void bench_raster(){
+    ILI9163_display display(bus, hwlib::pin_out_dummy, bus.wrx(), hwlib::pin_out_dummy);
+    std::printf("  spi bytes        spans    hwlib\n");
+    for(auto & s : shapes){
+        display.clear(hwlib::white);
+        size_t span = bytes_of(s.span, display);
+        display.clear(hwlib::white);
+        size_t pixels = bytes_of(s.pixels, display);
+        std::printf("  %-12s %8d %8d\n", s.name, (int) span, (int) pixels);
+    }
+}
@@ -0,0 +1,62 @@
+#include "bench.hpp"
+#include "rgb565_kernels.hpp"
+
+// the rgb565 kernels against the one pixel at a time references, on
+// window rows of 130 pixels: aligned, and with dst one pixel off a word
+// so the word kernels take their slow path, and the gradients over the
+// whole window
+
+////////////////////////////////////////////////////////////////////////
+
+alignas( 16 ) static uint16_t dst[132 * 129];
+alignas( 16 ) static uint16_t src[132 * 129];
+
+// Mpixel/s of f on every row of the window
+template< typename F >
+static double rate(F f){
+    const int frames = 400;
+    auto us = time_us(frames, [&](){
+        for(int y = 0; y < 129; y++){
+            f(dst + 132 * y, src + 132 * y, 130);
+        }
+    });
+    return 130.0 * 129 * frames / us;
+}
+
+static void row(const char * name, const rgb565_kernels & k, int offset){
+    std::printf("  %-10s %-9s %7.0f %7.0f %7.0f %7.0f %7.0f\n", name, k.name,
+        rate([&](uint16_t * d, uint16_t * s, size_t n){ k.fill(d + offset, n, 0x1234); }),
+        rate([&](uint16_t * d, uint16_t * s, size_t n){ k.copy(d + offset, s, n); }),
+        rate([&](uint16_t * d, uint16_t * s, size_t n){ k.keyed_copy(d + offset, s, n, 0xf81f); }),
+        rate([&](uint16_t * d, uint16_t * s, size_t n){ k.blend50(d + offset, s, n); }),
+        rate([&](uint16_t * d, uint16_t * s, size_t n){ k.blend(d + offset, s, n, 100); }));
+}
+
+// Mpixel/s of a 130 x 129 gradient
+static double gradient_rate(void (* gradient)(uint16_t *, int, int, int, uint16_t, uint16_t)){
+    const int frames = 400;
+    auto us = time_us(frames, [&](){
+        gradient(dst, 132, 130, 129, 0x0000, 0xffff);
+    });
+    return 130.0 * 129 * frames / us;
+}
+
+void bench_rgb565(){
+    for(int i = 0; i < 132 * 129; i++){
+        dst[i] = (uint16_t) (i * 2654435761u >> 16);
+        src[i] = i % 4 == 1 ? 0xf81f : (uint16_t) (i * 40503u);
+    }
+    std::printf("  Mpixel/s                  fill    copy   keyed blend50   blend\n");
+    static const rgb565_kernels * const sets[] = { &reference_kernels, &word_kernels, &library_kernels };
+    for(auto k : sets){
+        row("aligned", *k, 0);
+    }
+    for(auto k : sets){
+        row("unaligned", *k, 1);
+    }
+
+    std::printf("  Mpixel/s             gradient_h gradient_v\n");
+    for(auto k : sets){
+        std::printf("  %-20s %10.0f %10.0f\n", k->name, gradient_rate(k->gradient_h), gradient_rate(k->gradient_v));
+    }
+}
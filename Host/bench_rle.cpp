@@ -0,0 +1,97 @@
+#include "bench.hpp"
+#include "scenes.hpp"
+#include "ILI9163.hpp"
+#include "ILI9163_rle.hpp"
+
+// the run-length window against the 33540 byte buffered window: the host
+// time to draw into it (encode), the time and the bytes of a flush, and
+// the memory, for a game of snake and for a dashboard redrawn every frame
+
+////////////////////////////////////////////////////////////////////////
+
+using buffered = ILI9163_spi_128x128_buffered_res_wrx_cs;
+
+struct totals {
+    uint_fast64_t encode_us = 0, flush_us = 0;
+    size_t bytes = 0, memory = 0;
+    int frames = 0;
+};
+
+template< typename F >
+static uint_fast64_t timed(F f){
+    auto start = hwlib::now_us();
+    f();
+    return hwlib::now_us() - start;
+}
+
+// a game of snake, flushed every tick
+template< typename WINDOW >
+static totals snake(WINDOW & w, counting_bus & bus){
+    totals t;
+    snake_scene scene(w, 5);
+    w.flush();
+    bus.clear_count();
+    bool running = true;
+    while(running && t.frames < 2000){
+        t.encode_us += timed([&](){ running = scene.tick(); });
+        t.flush_us += timed([&](){ w.flush(); });
+        t.frames++;
+    }
+    t.bytes = bus.bytes();
+    return t;
+}
+
+// the dashboard, redrawn and flushed every frame
+template< typename WINDOW >
+static totals dashboard(WINDOW & w, counting_bus & bus){
+    totals t;
+    bus.clear_count();
+    for(; t.frames < 200; t.frames++){
+        t.encode_us += timed([&](){ draw_dashboard(w, t.frames); });
+        t.flush_us += timed([&](){ w.flush(); });
+    }
+    t.bytes = bus.bytes();
+    return t;
+}
+
+static void row(const char * name, const totals & t){
+    std::printf("  %-20s %9.1f %9.1f %9.0f %8d\n", name,
+        (double) t.encode_us / t.frames, (double) t.flush_us / t.frames,
+        (double) t.bytes / t.frames, (int) t.memory);
+}
+
+template< typename RLE >
+static void compare(const char * snake_name, const char * dashboard_name, RLE & runs, counting_bus & bus){
+    auto t = snake(runs, bus);
+    t.memory = runs.memory_reserved();
+    row(snake_name, t);
+    std::printf("  %-20s %d bytes in use, %d raw rows, %d direct rows\n", "",
+        (int) runs.memory_used(), (int) runs.raw_row_count(), (int) runs.direct_row_count());
+
+    t = dashboard(runs, bus);
+    t.memory = runs.memory_reserved();
+    row(dashboard_name, t);
+    std::printf("  %-20s %d bytes in use, %d raw rows, %d direct rows\n", "",
+        (int) runs.memory_used(), (int) runs.raw_row_count(), (int) runs.direct_row_count());
+}
+
+void bench_rle(){
+    static counting_bus bus;
+    static buffered frame(bus, hwlib::pin_out_dummy, hwlib::pin_out_dummy, hwlib::pin_out_dummy);
+    static ILI9163_spi_128x128_rle_storage_res_wrx_cs< 8, 8 > small(
+        bus, hwlib::pin_out_dummy, hwlib::pin_out_dummy, hwlib::pin_out_dummy);
+    static ILI9163_spi_128x128_rle_storage_res_wrx_cs< 16, 64 > large(
+        bus, hwlib::pin_out_dummy, hwlib::pin_out_dummy, hwlib::pin_out_dummy);
+
+    std::printf("  per frame            encode us  flush us     bytes   memory\n");
+
+    auto t = snake(frame, bus);
+    t.memory = 130 * 129 * 2;
+    row("snake buffered", t);
+    t = dashboard(frame, bus);
+    t.memory = 130 * 129 * 2;
+    row("dashboard buffered", t);
+
+    compare("snake rle 8/8", "dashboard rle 8/8", small, bus);
+    compare("snake rle 16/64", "dashboard rle 16/64", large, bus);
+}
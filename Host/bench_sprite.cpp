@@ -0,0 +1,62 @@
+#include "bench.hpp"
+#include "ILI9163.hpp"
+#include "ILI9163_sprite.hpp"
+
+// sprites per second: 8x8 sprites with transparent pixels moving one
+// pixel per step over a full screen image, each move redraws the 9x8 or
+// 8x9 window covering the old and the new position
+
+////////////////////////////////////////////////////////////////////////
+
+static uint16_t background_pixels[130 * 129];
+static uint16_t sprite_pixels[8 * 8];
+
+void bench_sprite(){
+    for(int i = 0; i < 130 * 129; i++){
+        background_pixels[i] = (uint16_t) (i * 2654435761u >> 16);
+    }
+    for(int i = 0; i < 8 * 8; i++){
+        int x = i % 8 - 4, y = i / 8 - 4;
+        sprite_pixels[i] = x * x + y * y > 16 ? 0xf81f : (uint16_t) (0x1234 + i);
+    }
+    static const ILI9163_sprite_image ball = { hwlib::xy(8, 8), 0xf81f, sprite_pixels };
+
+    counting_bus bus;
+    ILI9163_display display(bus, hwlib::pin_out_dummy, hwlib::pin_out_dummy, hwlib::pin_out_dummy);
+    ILI9163_image_background background(background_pixels);
+
+    static const int count = 16;
+    static ILI9163_sprite * sprites[count];
+    for(int i = 0; i < count; i++){
+        sprites[i] = new ILI9163_sprite(ball, hwlib::xy(7 * i, 7 * i));
+    }
+    ILI9163_sprite_layer layer(display, background, sprites, count);
+    layer.draw();
+
+    // every sprite bounces inside the window, alternating between x and y steps
+    int step = 0;
+    auto move_all = [&](){
+        for(int i = 0; i < count; i++){
+            ILI9163_sprite & s = *sprites[i];
+            hwlib::xy to = s.position + ((step + i) % 2 ? hwlib::xy(1, 0) : hwlib::xy(0, 1));
+            if(to.x > 122){ to.x = 0; }
+            if(to.y > 121){ to.y = 0; }
+            layer.move(s, to);
+        }
+        step++;
+    };
+
+    const int rounds = 20000;
+    bus.clear_count();
+    auto us = time_us(rounds, move_all);
+    double moves = (double) rounds * count;
+    double bytes = bus.bytes() / moves;
+    std::printf("  %d moves of 8x8 sprites\n", (int) moves);
+    std::printf("  host       %10.0f sprites/s\n", moves * 1e6 / us);
+    std::printf("  spi bytes  %10.1f per move\n", bytes);
+    std::printf("  due spi    %10.0f sprites/s at 21 MHz\n", due_spi_bytes_per_s / bytes);
+
+    for(auto s : sprites){
+        delete s;
+    }
+}
@@ -0,0 +1,75 @@
+#include "bench.hpp"
+#include "scenes.hpp"
+#include "ILI9163.hpp"
+
+// the 8x8 tile hashes of the buffered window: the bytes a flush sends
+// against a full flush (invalidate() before each flush) when every frame
+// is redrawn from scratch, and the time the hashing takes, measured as a
+// flush of a frame in which nothing changed
+
+////////////////////////////////////////////////////////////////////////
+
+using buffered = ILI9163_spi_128x128_buffered_res_wrx_cs;
+
+struct flush_totals {
+    uint_fast64_t us = 0;
+    size_t bytes = 0;
+};
+
+// redraw every frame with draw(frame) and flush it, full sends everything
+template< typename F >
+static flush_totals frames(buffered & w, counting_bus & bus, int n, bool full, F draw){
+    flush_totals t;
+    for(int f = 0; f < n; f++){
+        draw(f);
+        if(full){
+            w.invalidate();
+        }
+        bus.clear_count();
+        auto start = hwlib::now_us();
+        w.flush();
+        t.us += hwlib::now_us() - start;
+        t.bytes += bus.bytes();
+    }
+    return t;
+}
+
+template< typename F >
+static void workload(const char * name, buffered & w, counting_bus & bus, F draw){
+    const int n = 300;
+    auto tiles = frames(w, bus, n, false, draw);
+    auto full = frames(w, bus, n, true, draw);
+    std::printf("  %-14s %8.0f %8.0f %9.1f %9.1f\n", name,
+        (double) tiles.bytes / n, (double) full.bytes / n,
+        (double) tiles.us / n, (double) full.us / n);
+}
+
+void bench_tiles(){
+    static counting_bus bus;
+    static buffered w(bus, hwlib::pin_out_dummy, hwlib::pin_out_dummy, hwlib::pin_out_dummy);
+    static uint16_t pattern[130 * 129];
+
+    std::printf("  per flush          bytes            host us\n");
+    std::printf("                     tiles     full     tiles      full\n");
+
+    workload("dashboard", w, bus, [&](int f){
+        draw_dashboard(w, f);
+    });
+
+    // a game of snake, only the cells that moved are drawn
+    static snake_scene scene(w, 5);
+    workload("snake", w, bus, [&](int){
+        scene.tick();
+    });
+
+    // nothing is drawn, so the flush is only the hashing
+    workload("unchanged", w, bus, [&](int){});
+
+    // every pixel changes every frame: all hashing, no saving
+    workload("all changed", w, bus, [&](int f){
+        for(int i = 0; i < 130 * 129; i++){
+            pattern[i] = (uint16_t) ((i + f) * 40503u);
+        }
+        w.write_rect(hwlib::xy(0, 0), hwlib::xy(130, 129), pattern, 130);
+    });
+}
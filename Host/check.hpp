@@ -0,0 +1,72 @@
+#ifndef CHECK_HPP
+#define CHECK_HPP
+
+#include "hwlib.hpp"
+#include "ILI9163.hpp"
+#include "ILI9163_simulator.hpp"
+#include <cstdint>
+
+////////////////////////////////////////////////////////////////////////
+
+// count a failed check and print where it is, returns condition
+bool check_that(bool condition, const char * text, const char * file, int line);
+
+#define CHECK( condition ) check_that( (condition), #condition, __FILE__, __LINE__ )
+
+////////////////////////////////////////////////////////////////////////
+
+// an ILI9163 controller model on a simulated bus, hand bus and wrx() to a display
+struct simulated_panel {
+    ILI9163_simulator chip;
+    ILI9163_simulator_bus bus;
+
+    simulated_panel():
+        bus( chip )
+    {}
+
+    hwlib::pin_out & wrx(){
+        return bus.wrx();
+    }
+
+    // true when the w x h pixels at pos equal those of other
+    bool same(const simulated_panel & other, hwlib::xy pos = hwlib::xy(0, 0), hwlib::xy size = hwlib::xy(130, 129)) const {
+        for(int y = pos.y; y < pos.y + size.y; y++){
+            for(int x = pos.x; x < pos.x + size.x; x++){
+                if(chip.pixel(hwlib::xy(x, y)) != other.chip.pixel(hwlib::xy(x, y))){
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+}; // struct simulated_panel
+
+// pixels that differ from their neighbours, seeded so every run is the same
+inline uint16_t test_pixel(uint32_t seed, int i){
+    uint32_t h = (seed + 1) * 2654435761u ^ (uint32_t) i * 40503u;
+    h ^= h >> 15;
+    return (uint16_t) (h * 2246822519u >> 16);
+}
+
+////////////////////////////////////////////////////////////////////////
+
+// the checks, one function per part of the library
+void check_canvas();
+void check_display_list();
+void check_flush();
+void check_game();
+void check_image();
+void check_input();
+void check_lut();
+void check_power();
+void check_raster();
+void check_read();
+void check_rgb565();
+void check_rle();
+void check_spi_fast();
+void check_sprite();
+void check_tiled();
+
+////////////////////////////////////////////////////////////////////////
+
+#endif //CHECK_HPP
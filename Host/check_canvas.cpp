@@ -0,0 +1,151 @@
+#include "check.hpp"
+#include "ILI9163_canvas.hpp"
+#include "ILI9163_rgb565.hpp"
+
+// the canvas drawn onto the direct display, the buffered display and a
+// parent canvas, at positions inside, partly outside on every side and
+// fully outside, against a pixel by pixel reference, and hwlib drawing
+// into a canvas that runs off its edges without touching memory around it
+
+////////////////////////////////////////////////////////////////////////
+
+static const hwlib::xy child_size(23, 17);
+static const int guard = 64;
+static const uint16_t guard_pixel = 0xdead;
+
+// the storage of a canvas with a guard area in front and behind
+template< int N >
+struct guarded_storage {
+    uint16_t memory[guard + N + guard];
+
+    guarded_storage(){
+        for(auto & p : memory){
+            p = guard_pixel;
+        }
+    }
+
+    uint16_t * pixels(){
+        return memory + guard;
+    }
+
+    bool guards_intact() const {
+        for(int i = 0; i < guard; i++){
+            if(memory[i] != guard_pixel || memory[guard + N + i] != guard_pixel){
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+static const hwlib::xy positions[] = {
+    { 10, 20 }, { 0, 0 }, { 107, 112 },
+    // one pixel over the right and the bottom edge
+    { 108, 60 }, { 60, 113 },
+    // partly outside at the left, top, right, bottom and two corners
+    { -5, 40 }, { 50, -9 }, { 120, 30 }, { 60, 120 }, { -22, -16 }, { 129, 128 },
+    // fully outside
+    { -23, 10 }, { 10, -17 }, { 130, 10 }, { 10, 129 },
+};
+
+// the pixel at x, y of a target after drawing the child at pos over background
+static uint16_t expected(const ILI9163_canvas & child, hwlib::xy pos, int x, int y, uint16_t background){
+    int cx = x - pos.x, cy = y - pos.y;
+    if(cx >= 0 && cy >= 0 && cx < child.size.x && cy < child.size.y){
+        return child.pixels()[cx + child.size.x * cy];
+    }
+    return background;
+}
+
+template< typename PANEL >
+static bool shows(const PANEL & panel, const ILI9163_canvas & child, hwlib::xy pos, uint16_t background){
+    for(int y = 0; y < 129; y++){
+        for(int x = 0; x < 130; x++){
+            if(panel.chip.pixel(hwlib::xy(x, y)) != expected(child, pos, x, y, background)){
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void check_canvas(){
+    static guarded_storage< 23 * 17 > child_storage;
+    ILI9163_canvas child(child_size, child_storage.pixels());
+    for(int i = 0; i < child_size.x * child_size.y; i++){
+        child.pixels()[i] = test_pixel(34, i);
+    }
+    const uint16_t white = rgb565_from_color(hwlib::white);
+
+    // hwlib drawing is clipped to the canvas
+    {
+        static guarded_storage< 23 * 17 > storage;
+        ILI9163_canvas c(child_size, storage.pixels());
+        c.clear(hwlib::white);
+        hwlib::line(hwlib::xy(-30, -10), hwlib::xy(60, 40), hwlib::black).draw(c);
+        hwlib::circle(hwlib::xy(0, 0), 12, hwlib::black).draw(c);
+        c.write(hwlib::xy(23, 0), hwlib::black);
+        c.write(hwlib::xy(-1, 16), hwlib::black);
+        c.write(hwlib::xy(22, 16), hwlib::black);
+        CHECK( storage.guards_intact() );
+        CHECK( c.pixels()[22 + 23 * 16] == 0 );
+        CHECK( c.pixels()[0] == white );
+    }
+
+    // onto the direct display
+    {
+        static simulated_panel panel;
+        ILI9163_display d(panel.bus, hwlib::pin_out_dummy, panel.wrx(), hwlib::pin_out_dummy);
+        bool all = true;
+        for(auto pos : positions){
+            d.clear(hwlib::white);
+            child.draw(d, pos);
+            all = all && shows(panel, child, pos, white);
+        }
+        CHECK( all );
+
+        // nothing is sent for a canvas that is not visible
+        panel.bus.clear_count();
+        child.draw(d, hwlib::xy(-23, -17));
+        child.draw(d, hwlib::xy(130, 0));
+        CHECK( panel.bus.bytes() == 0 );
+    }
+
+    // into the buffer of the buffered display, shown after the flush
+    {
+        static simulated_panel panel;
+        static ILI9163_spi_128x128_buffered_res_wrx_cs b(panel.bus, hwlib::pin_out_dummy, panel.wrx(), hwlib::pin_out_dummy);
+        bool all = true;
+        for(auto pos : positions){
+            b.clear(hwlib::white);
+            child.draw(b, pos);
+            b.flush();
+            all = all && shows(panel, child, pos, white);
+        }
+        CHECK( all );
+    }
+
+    // into a parent canvas, with the parent's guards intact
+    {
+        static guarded_storage< 50 * 40 > parent_storage;
+        ILI9163_canvas parent(hwlib::xy(50, 40), parent_storage.pixels());
+        static const hwlib::xy parent_positions[] = {
+            { 5, 5 }, { 27, 23 }, { 28, 10 }, { 10, 24 }, { -10, 3 }, { 40, -8 }, { 45, 30 }, { -22, -16 }, { 49, 39 }, { 50, 0 }, { 0, -17 },
+        };
+        bool all = true;
+        for(auto pos : parent_positions){
+            for(int i = 0; i < 50 * 40; i++){
+                parent.pixels()[i] = 0x0841;
+            }
+            child.draw(parent, pos);
+            for(int y = 0; y < 40; y++){
+                for(int x = 0; x < 50; x++){
+                    all = all && parent.pixels()[x + 50 * y] == expected(child, pos, x, y, 0x0841);
+                }
+            }
+        }
+        CHECK( all );
+        CHECK( parent_storage.guards_intact() );
+        CHECK( child_storage.guards_intact() );
+    }
+}
@@ -0,0 +1,92 @@
+#include "check.hpp"
+#include "ILI9163_display_list.hpp"
+
+// a display list replayed into the controller model against the same
+// drawing done directly: clipped windows and fills, pixel runs split into
+// records of 127, data records longer than 255 bytes, replaying twice and
+// to a second display, and a list that runs out of room
+
+////////////////////////////////////////////////////////////////////////
+
+static uint16_t block[40 * 9];
+
+// the drawing of the list, done directly
+static void draw(ILI9163_display & d){
+    d.fill_rect(hwlib::xy(0, 0), hwlib::xy(130, 129), 0x0841);
+    d.fill_rect(hwlib::xy(3, 7), hwlib::xy(20, 11), 0xf800);
+    // clipped by the list
+    d.fill_rect(hwlib::xy(110, 0), hwlib::xy(20, 4), 0x07e0);
+    d.fill_rect(hwlib::xy(0, 120), hwlib::xy(9, 9), 0x001f);
+    d.write_rect(hwlib::xy(60, 30), hwlib::xy(40, 9), block, 40);
+    d.write_rect(hwlib::xy(10, 60), hwlib::xy(50, 3), block, 50);
+}
+
+void check_display_list(){
+    static simulated_panel list_panel, direct_panel, other_panel;
+    ILI9163_display listed(list_panel.bus, hwlib::pin_out_dummy, list_panel.wrx(), hwlib::pin_out_dummy);
+    ILI9163_display direct(direct_panel.bus, hwlib::pin_out_dummy, direct_panel.wrx(), hwlib::pin_out_dummy);
+    ILI9163_display other(other_panel.bus, hwlib::pin_out_dummy, other_panel.wrx(), hwlib::pin_out_dummy);
+    for(int i = 0; i < 40 * 9; i++){
+        block[i] = test_pixel(11, i);
+    }
+
+    static uint8_t buffer[4096];
+    ILI9163_display_list list(buffer, sizeof(buffer));
+    list.fill_rect(hwlib::xy(0, 0), hwlib::xy(130, 129), 0x0841);
+    list.fill_rect(hwlib::xy(3, 7), hwlib::xy(20, 11), 0xf800);
+    list.fill_rect(hwlib::xy(110, -3), hwlib::xy(30, 7), 0x07e0);
+    list.fill_rect(hwlib::xy(-4, 120), hwlib::xy(13, 20), 0x001f);
+
+    // nothing of these is visible, they record nothing
+    size_t before = list.size();
+    list.fill_rect(hwlib::xy(130, 5), hwlib::xy(10, 10), 0xffff);
+    list.fill_rect(hwlib::xy(-20, -20), hwlib::xy(20, 100), 0xffff);
+    CHECK( !list.window(5, 129, 20, 140) );
+    CHECK( list.size() == before );
+
+    // 360 pixels: records of 127, 127 and 106 pixels
+    CHECK( list.window(60, 30, 99, 38) );
+    before = list.size();
+    list.pixels(block, 40 * 9);
+    CHECK( list.size() - before == 3 * 2 + 2 * 360 );
+
+    // 300 data bytes: records of 255 and 45 bytes
+    CHECK( list.window(10, 60, 59, 62) );
+    before = list.size();
+    for(int y = 0; y < 3; y++){
+        for(int x = 0; x < 50; x++){
+            list.data16(block[x + 50 * y]);
+        }
+    }
+    CHECK( list.size() - before == 2 + 255 + 2 + 45 );
+    CHECK( !list.overflow() );
+
+    draw(direct);
+    list.replay(listed);
+    CHECK( list_panel.same(direct_panel) );
+
+    // again over a changed screen, and to another display
+    listed.clear(hwlib::white);
+    list.replay(listed);
+    list.replay(other);
+    CHECK( list_panel.same(direct_panel) );
+    CHECK( other_panel.same(direct_panel) );
+
+    // fewer bytes than the direct drawing, which has a transaction per command
+    list_panel.bus.clear_count();
+    direct_panel.bus.clear_count();
+    list.replay(listed);
+    draw(direct);
+    CHECK( list_panel.bus.bytes() <= direct_panel.bus.bytes() );
+
+    // a list that is full drops the records that do not fit, the others replay
+    static uint8_t small[40];
+    ILI9163_display_list short_list(small, sizeof(small));
+    short_list.fill_rect(hwlib::xy(0, 0), hwlib::xy(130, 129), 0xabcd);
+    short_list.pixels(block, 40);
+    CHECK( short_list.overflow() );
+    CHECK( short_list.size() == 10 );
+    short_list.replay(listed);
+    direct.fill_rect(hwlib::xy(0, 0), hwlib::xy(130, 129), 0xabcd);
+    CHECK( list_panel.same(direct_panel) );
+}
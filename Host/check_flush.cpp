@@ -0,0 +1,129 @@
+#include "check.hpp"
+
+// flush_step and flush_for against one flush() of the same buffer on a
+// second panel: budgets that end inside a band and inside a row, changes
+// between the steps of a frame, and the tile hashes over several frames
+
+////////////////////////////////////////////////////////////////////////
+
+using buffered = ILI9163_spi_128x128_buffered_res_wrx_cs;
+
+// the same block of test pixels in both buffers
+static void draw(buffered & a, buffered & b, hwlib::xy pos, hwlib::xy size, uint32_t seed){
+    static uint16_t block[130 * 129];
+    for(int i = 0; i < size.x * size.y; i++){
+        block[i] = test_pixel(seed, i);
+    }
+    a.write_rect(pos, size, block, size.x);
+    b.write_rect(pos, size, block, size.x);
+}
+
+// the rows of the band that starts at row
+static int band_rows(int row){
+    return 129 - row < 8 ? 129 - row : 8;
+}
+
+// whether a step from row before to row after sent as many whole bands as
+// fit in max_rows and no more, or a single band when none fits
+static bool whole_bands(int before, int after, int max_rows){
+    int rows = after - before;
+    if(before % 8 != 0 || (after % 8 != 0 && after != 129)){
+        return false;
+    }
+    if(rows <= band_rows(before)){
+        return rows == band_rows(before) && (after == 129 || rows + band_rows(after) > max_rows);
+    }
+    return rows <= max_rows && (after == 129 || rows + band_rows(after) > max_rows);
+}
+
+// flush_step(rows) until the frame is done, returns the number of calls,
+// or -1 when a call did not send the rows its budget allows
+static int steps(buffered & display, uint_fast16_t rows){
+    int n = 0;
+    bool done = false;
+    while(!done && n < 1000){
+        int before = display.next_row();
+        done = display.flush_step(rows);
+        if(!whole_bands(before, done ? 129 : display.next_row(), rows)){
+            return -1;
+        }
+        n++;
+    }
+    return n;
+}
+
+void check_flush(){
+    static simulated_panel stepped_panel, whole_panel;
+    static buffered stepped(stepped_panel.bus, hwlib::pin_out_dummy, stepped_panel.wrx(), hwlib::pin_out_dummy);
+    static buffered whole(whole_panel.bus, hwlib::pin_out_dummy, whole_panel.wrx(), hwlib::pin_out_dummy);
+
+    // 17 bands of 8 rows, the last one a single row; a budget is rounded down
+    // to whole bands, but a call sends at least one
+    static const int budgets[][2] = {
+        // rows, calls per frame
+        { 1, 17 }, { 3, 17 }, { 8, 17 }, { 9, 16 }, { 13, 16 }, { 16, 9 }, { 17, 8 },
+        { 40, 4 }, { 128, 2 }, { 129, 1 }, { 500, 1 },
+    };
+    uint32_t seed = 1;
+    for(auto & b : budgets){
+        draw(stepped, whole, hwlib::xy(0, 0), hwlib::xy(130, 129), seed++);
+        whole.flush();
+        CHECK( steps(stepped, b[0]) == b[1] );
+        CHECK( stepped_panel.same(whole_panel) );
+
+        // a small change only sends its tiles
+        draw(stepped, whole, hwlib::xy(61, 127), hwlib::xy(3, 2), seed++);
+        whole.flush();
+        stepped_panel.bus.clear_count();
+        CHECK( steps(stepped, b[0]) == b[1] );
+        CHECK( stepped_panel.same(whole_panel) );
+        CHECK( stepped_panel.bus.bytes() < 2 * 8 * 8 * 2 + 64 );
+    }
+
+    // changes between the steps, in bands that were sent and bands that were not,
+    // show after the next frame
+    draw(stepped, whole, hwlib::xy(0, 0), hwlib::xy(130, 129), seed++);
+    stepped.flush_step(5);
+    stepped.flush_step(20);
+    draw(stepped, whole, hwlib::xy(10, 3), hwlib::xy(30, 20), seed++);
+    draw(stepped, whole, hwlib::xy(100, 90), hwlib::xy(30, 39), seed++);
+    stepped.flush_step(7);
+    draw(stepped, whole, hwlib::xy(0, 20), hwlib::xy(130, 1), seed++);
+    CHECK( steps(stepped, 11) == 12 );
+    whole.flush();
+    CHECK( !stepped_panel.same(whole_panel) );
+    CHECK( steps(stepped, 11) == 16 );
+    CHECK( stepped_panel.same(whole_panel) );
+
+    // invalidate in the middle of a frame starts over and sends everything
+    stepped.flush_step(16);
+    stepped.invalidate();
+    stepped_panel.bus.clear_count();
+    CHECK( steps(stepped, 1) == 17 );
+    CHECK( stepped_panel.bus.bytes() >= 130 * 129 * 2 );
+    CHECK( stepped_panel.same(whole_panel) );
+
+    // time budgets shorter than a row: every call sends exactly one band
+    static const uint_fast32_t times[] = { 0, 1, 7 };
+    for(auto us : times){
+        draw(stepped, whole, hwlib::xy(0, 0), hwlib::xy(130, 129), seed++);
+        whole.flush();
+        int n = 0;
+        bool done = false, one_band = true;
+        while(!done && n < 1000){
+            int before = stepped.next_row();
+            done = stepped.flush_for(us);
+            one_band = one_band && (done ? 129 : (int) stepped.next_row()) - before == band_rows(before);
+            n++;
+        }
+        CHECK( one_band );
+        CHECK( n == 17 );
+        CHECK( stepped_panel.same(whole_panel) );
+    }
+
+    // a budget for the whole frame sends it in one call
+    draw(stepped, whole, hwlib::xy(0, 0), hwlib::xy(130, 129), seed++);
+    whole.flush();
+    CHECK( stepped.flush_for(1000000) );
+    CHECK( stepped_panel.same(whole_panel) );
+}
@@ -0,0 +1,42 @@
+#include "check.hpp"
+#include "game.hpp"
+#include "headless.hpp"
+
+// the foods of a game: spawn_food() refuses a food on top of another,
+// since tick() no longer lets two foods push each other apart, and a
+// full pool
+
+////////////////////////////////////////////////////////////////////////
+
+void check_game(){
+    static null_window w;
+    static xorshift_random rnd(1);
+    static game g(w, rnd);
+
+    // the game starts with one food at (100, 63), a food covers 3 pixels
+    // around its midpoint, so two foods touch up to 6 pixels apart
+    CHECK( g.food_count() == 1 );
+    CHECK( g.spawn_food(hwlib::xy(100, 63)) == nullptr );
+    CHECK( g.spawn_food(hwlib::xy(106, 69)) == nullptr );
+    CHECK( g.spawn_food(hwlib::xy(94, 57)) == nullptr );
+    CHECK( g.food_count() == 1 );
+
+    food * right = g.spawn_food(hwlib::xy(107, 63));
+    CHECK( right != nullptr );
+    CHECK( g.spawn_food(hwlib::xy(103, 66)) == nullptr );
+    CHECK( g.food_count() == 2 );
+
+    // a removed food frees its place
+    g.despawn_food(right);
+    CHECK( g.spawn_food(hwlib::xy(103, 70)) != nullptr );
+    CHECK( g.food_count() == 2 );
+
+    // a grid of foods clear of each other fills the pool, then none fit
+    bool spawned = true;
+    for(int i = 2; i < MAX_FOODS; i++){
+        spawned = spawned && g.spawn_food(hwlib::xy(20 + 12 * (i % 8), 32 + 24 * (i / 8))) != nullptr;
+    }
+    CHECK( spawned );
+    CHECK( g.food_count() == MAX_FOODS );
+    CHECK( g.spawn_food(hwlib::xy(60, 110)) == nullptr );
+}
@@ -0,0 +1,191 @@
+#include "check.hpp"
+#include "ILI9163_image.hpp"
+#include "ILI9163_rgb565.hpp"
+#include <cstring>
+
+// the BMP and PPM decoders against pixels computed from the same samples:
+// bottom-up and top-down BMP with row padding, PPM with a comment and a
+// maxval below 255, clipping on every side, and headers that must be refused
+
+////////////////////////////////////////////////////////////////////////
+
+static uint8_t file[64 * 1024];
+static size_t file_size;
+
+static void put(uint8_t b){
+    file[file_size++] = b;
+}
+
+static void put32(uint32_t v){
+    for(int i = 0; i < 4; i++){
+        put((uint8_t) (v >> (8 * i)));
+    }
+}
+
+static void put_text(const char * text){
+    while(*text != 0){
+        put((uint8_t) *text++);
+    }
+}
+
+// the sample of channel c (0 red, 1 green, 2 blue) of pixel x, y of an image
+static int sample(int x, int y, int c, int maxval){
+    int v = c == 0 ? x * 7 + y * 3 : c == 1 ? (x * 5) ^ (y * 11) : x + y * 13;
+    return (v & 255) % (maxval + 1);
+}
+
+static void make_bmp(int width, int height, bool top_down){
+    int padding = (4 - (3 * width) % 4) % 4;
+    file_size = 0;
+    put('B'); put('M');
+    put32(54 + (3 * width + padding) * height);
+    put32(0);
+    put32(54);
+    put32(40);
+    put32(width);
+    put32(top_down ? -height : height);
+    put(1); put(0); put(24); put(0);
+    for(int i = 0; i < 6; i++){
+        put32(0);
+    }
+    for(int i = 0; i < height; i++){
+        int y = top_down ? i : height - 1 - i;
+        for(int x = 0; x < width; x++){
+            put(sample(x, y, 2, 255));
+            put(sample(x, y, 1, 255));
+            put(sample(x, y, 0, 255));
+        }
+        for(int p = 0; p < padding; p++){
+            put(0);
+        }
+    }
+}
+
+static void make_ppm(int width, int height, int maxval){
+    char header[64];
+    std::snprintf(header, sizeof(header), "P6\n# check\n%d %d\n%d\n", width, height, maxval);
+    file_size = 0;
+    put_text(header);
+    for(int y = 0; y < height; y++){
+        for(int x = 0; x < width; x++){
+            for(int c = 0; c < 3; c++){
+                put(sample(x, y, c, maxval));
+            }
+        }
+    }
+}
+
+// the GRAM before a draw, outside the image it must stay the same
+static uint16_t before[130 * 129];
+
+static void remember(const simulated_panel & panel){
+    for(int y = 0; y < 129; y++){
+        for(int x = 0; x < 130; x++){
+            before[x + 130 * y] = panel.chip.pixel(hwlib::xy(x, y));
+        }
+    }
+}
+
+// true when the panel shows the image of size at pos over the remembered GRAM
+static bool shows(const simulated_panel & panel, hwlib::xy pos, hwlib::xy size, int maxval){
+    for(int y = 0; y < 129; y++){
+        for(int x = 0; x < 130; x++){
+            hwlib::xy at = hwlib::xy(x, y) - pos;
+            uint16_t expect = before[x + 130 * y];
+            if(at.x >= 0 && at.y >= 0 && at.x < size.x && at.y < size.y){
+                expect = rgb565_from_color(hwlib::color(
+                    sample(at.x, at.y, 0, maxval) * 255 / maxval,
+                    sample(at.x, at.y, 1, maxval) * 255 / maxval,
+                    sample(at.x, at.y, 2, maxval) * 255 / maxval));
+            }
+            if(panel.chip.pixel(hwlib::xy(x, y)) != expect){
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static bool draw_bmp(ILI9163_spi_res_wrx_cs & display, hwlib::xy pos){
+    ILI9163_memory_reader reader(file, file_size);
+    return ILI9163_draw_bmp(display, reader, pos);
+}
+
+static bool draw_ppm(ILI9163_spi_res_wrx_cs & display, hwlib::xy pos){
+    ILI9163_memory_reader reader(file, file_size);
+    return ILI9163_draw_ppm(display, reader, pos);
+}
+
+void check_image(){
+    simulated_panel panel;
+    ILI9163_display display(panel.bus, hwlib::pin_out_dummy, panel.wrx(), hwlib::pin_out_dummy);
+    display.clear(hwlib::black);
+
+    // 37 pixel rows have a byte of padding
+    static const bool directions[] = { false, true };
+    for(bool top_down : directions){
+        make_bmp(37, 23, top_down);
+        remember(panel);
+        CHECK( draw_bmp(display, hwlib::xy(10, 20)) );
+        CHECK( shows(panel, hwlib::xy(10, 20), hwlib::xy(37, 23), 255) );
+
+        // over the top right and the bottom left corner
+        make_bmp(50, 40, top_down);
+        remember(panel);
+        CHECK( draw_bmp(display, hwlib::xy(100, -10)) );
+        CHECK( shows(panel, hwlib::xy(100, -10), hwlib::xy(50, 40), 255) );
+        remember(panel);
+        CHECK( draw_bmp(display, hwlib::xy(-7, 110)) );
+        CHECK( shows(panel, hwlib::xy(-7, 110), hwlib::xy(50, 40), 255) );
+    }
+
+    make_ppm(41, 17, 255);
+    remember(panel);
+    CHECK( draw_ppm(display, hwlib::xy(5, 60)) );
+    CHECK( shows(panel, hwlib::xy(5, 60), hwlib::xy(41, 17), 255) );
+
+    make_ppm(41, 17, 100);
+    remember(panel);
+    CHECK( draw_ppm(display, hwlib::xy(-20, 120)) );
+    CHECK( shows(panel, hwlib::xy(-20, 120), hwlib::xy(41, 17), 100) );
+
+    // larger than the display on every side
+    make_bmp(140, 135, false);
+    remember(panel);
+    CHECK( draw_bmp(display, hwlib::xy(-5, -3)) );
+    CHECK( shows(panel, hwlib::xy(-5, -3), hwlib::xy(140, 135), 255) );
+
+    // a file that ends early
+    make_bmp(20, 10, false);
+    file_size -= 5;
+    CHECK( !draw_bmp(display, hwlib::xy(0, 0)) );
+    make_ppm(20, 10, 255);
+    file_size -= 5;
+    CHECK( !draw_ppm(display, hwlib::xy(0, 0)) );
+
+    // sizes that would overflow the row arithmetic, refused before any pixel is sent
+    static const uint32_t widths[] = { 0, 0x80000000, 0x7fffffff, 64 * 130 + 1 };
+    static const uint32_t heights[] = { 0, 0x80000000, 0x7fffffff, (uint32_t) -(64 * 130 + 1), 64 * 130 + 1 };
+    make_bmp(4, 4, false);
+    for(auto w : widths){
+        std::memcpy(file + 18, &w, 4);
+        panel.bus.clear_count();
+        CHECK( !draw_bmp(display, hwlib::xy(0, 0)) );
+        CHECK( panel.bus.bytes() == 0 );
+    }
+    uint32_t four = 4;
+    std::memcpy(file + 18, &four, 4);
+    for(auto h : heights){
+        std::memcpy(file + 22, &h, 4);
+        panel.bus.clear_count();
+        CHECK( !draw_bmp(display, hwlib::xy(0, 0)) );
+        CHECK( panel.bus.bytes() == 0 );
+    }
+
+    file_size = 0;
+    put_text("P6 8321 1 255\n");
+    CHECK( !draw_ppm(display, hwlib::xy(0, 0)) );
+    file_size = 0;
+    put_text("P6 1 8321 255\n");
+    CHECK( !draw_ppm(display, hwlib::xy(0, 0)) );
+}
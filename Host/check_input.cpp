@@ -0,0 +1,139 @@
+#include "check.hpp"
+#include "input_queue.hpp"
+
+// the debounced button sampler with simulated bouncing buttons,
+// sampled at 1 kHz with the default threshold of 5 samples, and the
+// timestamps of the events it queues
+
+////////////////////////////////////////////////////////////////////////
+
+// an active low button, the test sets the level before each sample
+class bouncing_button : public hwlib::pin_in_out {
+public:
+    bool level = true;
+
+    bool read() override {
+        return level;
+    }
+
+    void write(bool) override {}
+    void direction_set_input() override {}
+    void direction_set_output() override {}
+}; // class bouncing_button
+
+struct button_bench {
+    bouncing_button right, left, up, down;
+    direction_queue events;
+    input_sampler sampler;
+    queued_input input;
+
+    button_bench(uint32_t period_us = 1000):
+        sampler( right, left, up, down, events, period_us ),
+        input( events )
+    {}
+
+    // sample n times with the pattern as level of button b, 0 is pressed,
+    // the pattern is repeated when it is shorter than n
+    void run(bouncing_button & b, const char * pattern, int n){
+        int length = 0;
+        while(pattern[length] != '\0'){
+            length++;
+        }
+        for(int i = 0; i < n; i++){
+            b.level = pattern[i % length] != '0';
+            sampler.sample();
+        }
+    }
+
+    // up to 8 events from the queue, as the button mask of each
+    int drain(uint8_t masks[8]){
+        int n = 0;
+        uint8_t m;
+        while(n < 8 && (m = input.buttons()) != 0){
+            masks[n++] = m;
+        }
+        return n;
+    }
+}; // struct button_bench
+
+////////////////////////////////////////////////////////////////////////
+
+void check_input(){
+    uint8_t masks[8];
+
+    // a press that bounces for 4 ms and then holds gives one event, holding does not repeat
+    {
+        button_bench b;
+        b.run(b.up, "0101", 4);
+        CHECK( b.events.empty() );
+        b.run(b.up, "0", 200);
+        CHECK( b.drain(masks) == 1 && masks[0] == INPUT_UP );
+
+        // releasing with bounce gives nothing
+        b.run(b.up, "10", 6);
+        b.run(b.up, "1", 50);
+        CHECK( b.drain(masks) == 0 );
+    }
+
+    // a press shorter than the debounce window is ignored, also when it repeats
+    {
+        button_bench b;
+        b.run(b.left, "0000111111", 300);
+        CHECK( b.drain(masks) == 0 );
+    }
+
+    // exactly the threshold is enough
+    {
+        button_bench b;
+        b.run(b.left, "00000", 5);
+        b.run(b.left, "1", 10);
+        CHECK( b.drain(masks) == 1 && masks[0] == INPUT_LEFT );
+    }
+
+    // two turns within one game tick (100 ms at 10 ticks per second)
+    // are both played, one per tick, in the order they were pressed
+    {
+        button_bench b;
+        b.run(b.right, "1", 10);
+        b.run(b.up, "01", 4);
+        b.run(b.up, "0", 26);
+        b.run(b.up, "1", 10);
+        b.run(b.left, "0", 30);
+        b.run(b.left, "1", 20);
+        CHECK( b.input.buttons() == INPUT_UP );
+        CHECK( b.input.buttons() == INPUT_LEFT );
+        CHECK( b.input.buttons() == 0 );
+    }
+
+    // a full queue drops further presses instead of overwriting
+    {
+        button_bench b;
+        for(int i = 0; i < 20; i++){
+            b.run(b.down, "0", 6);
+            b.run(b.down, "1", 6);
+        }
+        CHECK( b.drain(masks) == 8 );
+        int rest = 0;
+        while(b.input.buttons() != 0){
+            rest++;
+        }
+        CHECK( rest == 16 - 8 );
+    }
+
+    // the timestamp is the time of the sample that confirmed the press:
+    // the up press settles at sample 5 and is confirmed at sample 9, the
+    // left press starts at sample 35 and is confirmed at sample 39
+    static const uint32_t periods[] = { 1000, 2000 };
+    for(uint32_t period : periods){
+        button_bench b(period);
+        CHECK( b.sampler.period() == period );
+        b.run(b.up, "0101", 4);
+        b.run(b.up, "0", 10);
+        b.run(b.up, "1", 20);
+        b.run(b.left, "0", 10);
+        direction_event e;
+        CHECK( b.events.pop(e) && 1 << e.direction == INPUT_UP && e.timestamp_us == 9 * period );
+        CHECK( b.events.pop(e) && 1 << e.direction == INPUT_LEFT && e.timestamp_us == 39 * period );
+        CHECK( !b.events.pop(e) );
+    }
+}
@@ -0,0 +1,131 @@
+#include "check.hpp"
+#include "ILI9163_lut.hpp"
+#include "ILI9163_rgb565.hpp"
+
+// the colour LUT tables: identity, inverted and brightness, the ends of a
+// fade and the rounding half way, and the order of the fields as the
+// controller model receives them from write(), against the fields of a
+// pixel as the driver packs it; and write() as one traced burst
+
+////////////////////////////////////////////////////////////////////////
+
+static bool same(const ILI9163_lut & a, const ILI9163_lut & b){
+    for(int i = 0; i < ILI9163_lut::size; i++){
+        if(a.entries[i] != b.entries[i]){
+            return false;
+        }
+    }
+    return true;
+}
+
+// true when every entry of lut is level
+static bool all(const ILI9163_lut & lut, int level){
+    for(int i = 0; i < ILI9163_lut::size; i++){
+        if(lut.entries[i] != level){
+            return false;
+        }
+    }
+    return true;
+}
+
+// computed by the compiler, as a fade in flash would be
+static constexpr auto identity = ILI9163_lut::identity();
+static constexpr auto black = ILI9163_lut::solid(0, 0, 0);
+static constexpr auto white = ILI9163_lut::solid(255, 255, 255);
+static constexpr auto fade_in = ILI9163_lut_fade< 2 >(black, white);
+static constexpr auto fade_out = ILI9163_lut_fade< 2 >(white, black);
+static constexpr auto fade_16 = ILI9163_lut_fade< 16 >(identity, black);
+
+void check_lut(){
+    // 5 bit fields to 6 bit levels, 0 stays 0 and 31 becomes 63
+    using lut = ILI9163_lut;
+    CHECK( identity.entries[lut::blue_first] == 0 );
+    CHECK( identity.entries[lut::blue_first + 1] == 2 );
+    CHECK( identity.entries[lut::blue_first + 16] == 33 );
+    CHECK( identity.entries[lut::blue_first + 31] == 63 );
+    CHECK( identity.entries[lut::red_first + 15] == 30 );
+    CHECK( identity.entries[lut::red_first + 31] == 63 );
+    bool green = true;
+    for(int i = 0; i < 64; i++){
+        green = green && identity.entries[lut::green_first + i] == i;
+    }
+    CHECK( green );
+
+    auto inverted = lut::inverted();
+    bool complement = true;
+    for(int i = 0; i < lut::size; i++){
+        complement = complement && inverted.entries[i] == 63 - identity.entries[i];
+    }
+    CHECK( complement );
+    CHECK( inverted.entries[lut::blue_first] == 63 );
+    CHECK( inverted.entries[lut::green_first + 63] == 0 );
+
+    // the ends, and 63 * 128 / 255 = 31.6 rounds to 32, 63 * 127 / 255 = 31.4 to 31
+    CHECK( all(lut::brightness(0), 0) );
+    CHECK( same(lut::brightness(255), identity) );
+    CHECK( lut::brightness(128).entries[lut::green_first + 63] == 32 );
+    CHECK( lut::brightness(127).entries[lut::green_first + 63] == 31 );
+    CHECK( lut::brightness(128).entries[lut::green_first + 1] == 1 );
+    CHECK( lut::brightness(127).entries[lut::green_first + 1] == 0 );
+
+    // a fade starts at from and ends at to, steps past the end stay at to
+    CHECK( fade_16.count == 17 );
+    CHECK( same(fade_16[0], identity) );
+    CHECK( same(fade_16[16], black) );
+    CHECK( same(fade_16[100], black) );
+
+    // half way between 0 and 63 is 31.5: away from zero in both directions,
+    // so a fade out is the mirror of the fade in
+    CHECK( all(fade_in[0], 0) );
+    CHECK( all(fade_in[1], 32) );
+    CHECK( all(fade_in[2], 63) );
+    CHECK( all(fade_out[1], 31) );
+    // and towards black, 63 to 31.5 and 1 to 0.5, rounds down
+    CHECK( fade_16[8].entries[lut::green_first + 63] == 31 );
+    CHECK( fade_16[8].entries[lut::green_first + 1] == 0 );
+    CHECK( fade_16[8].entries[lut::green_first + 2] == 1 );
+
+    // written through a display to the controller model
+    static simulated_panel panel;
+    ILI9163_display d(panel.bus, hwlib::pin_out_dummy, panel.wrx(), hwlib::pin_out_dummy);
+    identity.write(d);
+    bool received = true;
+    for(int i = 0; i < lut::size; i++){
+        received = received && panel.chip.lut(i) == identity.entries[i];
+    }
+    CHECK( received );
+
+    // the command and one burst of 128 bytes, traced as two records, and
+    // the trace replays the same LUT into a second controller model
+    static ILI9163_trace_record records[8];
+    static uint16_t bytes[256];
+    static ILI9163_trace trace(records, 8, bytes, 256);
+    d.capture(&trace);
+    panel.bus.clear_count();
+    fade_16[4].write(d);
+    d.capture(nullptr);
+    CHECK( panel.bus.bytes() == 1 + lut::size );
+    CHECK( trace.size() == 2 );
+    CHECK( trace[0].kind == ILI9163_trace_kind::command && trace[0].byte == 0x2d );
+    CHECK( trace[1].kind == ILI9163_trace_kind::bytes && trace[1].count == lut::size );
+    static ILI9163_simulator replayed;
+    replayed.replay(trace);
+    bool same_lut = true;
+    for(int i = 0; i < lut::size; i++){
+        same_lut = same_lut && replayed.lut(i) == fade_16[4].entries[i] && panel.chip.lut(i) == replayed.lut(i);
+    }
+    CHECK( same_lut );
+
+    // the field of a pixel selects the entry of the same colour: a pure
+    // blue, green and red pixel each find their level in their own field
+    lut::solid(40, 80, 120).write(d);
+    uint16_t blue = rgb565_from_color(hwlib::color(0, 0, 255));
+    uint16_t green_pixel = rgb565_from_color(hwlib::color(0, 255, 0));
+    uint16_t red = rgb565_from_color(hwlib::color(255, 0, 0));
+    CHECK( panel.chip.lut(blue >> 11) == 120 >> 2 );
+    CHECK( panel.chip.lut(32 + (green_pixel >> 5 & 63)) == 80 >> 2 );
+    CHECK( panel.chip.lut(96 + (red & 31)) == 40 >> 2 );
+    CHECK( panel.chip.lut(0) == 120 >> 2 );
+    CHECK( panel.chip.lut(32) == 80 >> 2 );
+    CHECK( panel.chip.lut(96) == 40 >> 2 );
+}
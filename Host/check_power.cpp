@@ -0,0 +1,128 @@
+#include "check.hpp"
+#include "ILI9163_power.hpp"
+
+// the power and refresh commands against the controller model: the
+// frame rate setting that frame_rate() chooses against every setting,
+// the partial area, idle and sleep, with their bytes; and the active and
+// sleep time of the frame pacer for a known schedule on a simulated clock
+
+////////////////////////////////////////////////////////////////////////
+
+static const uint32_t fosc = 67'456;
+
+// the frame rate of a FRAME_RATE_CONTROL1 setting, as frame_rate() estimates it
+static uint32_t rate_of(uint32_t diva, uint32_t vpa){
+    return fosc / (diva * (128 + vpa));
+}
+
+// the smallest difference to hz of any setting
+static uint32_t best_error(uint32_t hz){
+    uint32_t best = ~0u;
+    for(uint32_t diva = 1; diva <= 31; diva++){
+        for(uint32_t vpa = 0; vpa <= 63; vpa++){
+            uint32_t rate = rate_of(diva, vpa);
+            uint32_t error = rate > hz ? rate - hz : hz - rate;
+            best = error < best ? error : best;
+        }
+    }
+    return best;
+}
+
+// a pacer on a simulated clock: each frame takes the time the check
+// gives it, and an interrupt wakes the sleep every 4 ms like a timer
+class simulated_pacer : public ILI9163_frame_pacer {
+private:
+    uint_fast64_t time = 1000;
+
+protected:
+    uint_fast64_t now_us() override {
+        return time;
+    }
+
+    void sleep_until(uint_fast64_t us) override {
+        time = us < time + 4000 ? us : time + 4000;
+    }
+
+public:
+    uint_fast32_t wakeups = 0;
+
+    simulated_pacer(uint_fast32_t hz):
+        ILI9163_frame_pacer( hz )
+    {
+        restart();
+    }
+
+    // a frame that works for us, then waits
+    void frame(uint_fast64_t us){
+        time += us;
+        wait();
+    }
+}; // class simulated_pacer
+
+void check_power(){
+    static simulated_panel panel;
+    ILI9163_display d(panel.bus, hwlib::pin_out_dummy, panel.wrx(), hwlib::pin_out_dummy);
+
+    // the power on setting gives 62 Hz
+    CHECK( d.frame_rate(62) == 62 );
+    CHECK( panel.chip.diva == 8 && panel.chip.vpa == 8 );
+
+    // the setting sent is the one returned, and none comes closer
+    static const uint32_t rates[] = { 0, 1, 10, 25, 30, 40, 50, 60, 61, 70, 100, 200, 527, 1000 };
+    bool closest = true;
+    for(auto hz : rates){
+        panel.bus.clear_count();
+        uint32_t rate = d.frame_rate(hz);
+        uint32_t diva = panel.chip.diva, vpa = panel.chip.vpa;
+        closest = closest && panel.bus.bytes() == 3;
+        closest = closest && diva >= 1 && diva <= 31 && vpa <= 63;
+        closest = closest && rate == rate_of(diva, vpa);
+        uint32_t target = hz == 0 ? 1 : hz;
+        uint32_t error = rate > target ? rate - target : target - rate;
+        closest = closest && error == best_error(target);
+    }
+    CHECK( closest );
+
+    // the partial area: the command, 2 rows of 2 bytes and enter_partial_mode
+    panel.bus.clear_count();
+    d.partial_mode(10, 300);
+    CHECK( panel.bus.bytes() == 6 );
+    CHECK( panel.chip.partial );
+    CHECK( panel.chip.partial_first == 10 && panel.chip.partial_last == 300 );
+    d.normal_mode();
+    CHECK( !panel.chip.partial );
+
+    panel.bus.clear_count();
+    d.idle_mode(true);
+    CHECK( panel.chip.idle );
+    d.idle_mode(false);
+    CHECK( !panel.chip.idle );
+    CHECK( panel.bus.bytes() == 2 );
+
+    d.sleep_mode(true);
+    CHECK( panel.chip.sleeping );
+    d.sleep_mode(false);
+    CHECK( !panel.chip.sleeping );
+
+    // at 50 Hz (20 ms) starting at 1 ms: two frames of 5 ms and a sleep
+    // of 15 ms each, a late frame of 30 ms that restarts the schedule at
+    // 71 ms, a frame of 5 ms, and a frame of 20 ms that ends exactly on
+    // the next frame and so is late too
+    simulated_pacer pacer(50);
+    pacer.frame(5000);
+    pacer.frame(5000);
+    CHECK( pacer.sleep_us() == 30000 );
+    pacer.frame(30000);
+    CHECK( pacer.late_frames() == 1 );
+    pacer.frame(5000);
+    pacer.frame(20000);
+    CHECK( pacer.frames() == 5 );
+    CHECK( pacer.late_frames() == 2 );
+    CHECK( pacer.active_us() == 65000 );
+    CHECK( pacer.sleep_us() == 45000 );
+    CHECK( pacer.duty_percent() == 59 );
+
+    // a pacer that did nothing counts as fully active
+    simulated_pacer idle(50);
+    CHECK( idle.duty_percent() == 100 );
+}
@@ -0,0 +1,301 @@
+#include "check.hpp"
+#include "ILI9163_raster.hpp"
+#include "ILI9163_rgb565.hpp"
+
+// the span rasterizers against the same shapes drawn one pixel at a time
+// on a second panel (Bresenham and midpoint, clipped by the window), and
+// the bytes they send against hwlib::line and hwlib::circle. The filled
+// triangles and rounded rectangles include degenerate, clipped and even
+// sized cases
+
+////////////////////////////////////////////////////////////////////////
+
+static const uint16_t ink = 0xf800;
+static const hwlib::color ink_color(0, 0, 255);
+
+static void plot(hwlib::window & w, int x, int y){
+    w.write(hwlib::xy(x, y), ink_color);
+}
+
+static void reference_line(hwlib::window & w, hwlib::xy a, hwlib::xy b){
+    int dx = b.x > a.x ? b.x - a.x : a.x - b.x;
+    int dy = b.y > a.y ? b.y - a.y : a.y - b.y;
+    int sx = b.x > a.x ? 1 : -1;
+    int sy = b.y > a.y ? 1 : -1;
+    if(dx >= dy){
+        int err = dx / 2;
+        for(int x = a.x, y = a.y; ; x += sx){
+            plot(w, x, y);
+            if(x == b.x){
+                break;
+            }
+            err -= dy;
+            if(err < 0){
+                y += sy;
+                err += dx;
+            }
+        }
+    }else{
+        int err = dy / 2;
+        for(int y = a.y, x = a.x; ; y += sy){
+            plot(w, x, y);
+            if(y == b.y){
+                break;
+            }
+            err -= dx;
+            if(err < 0){
+                x += sx;
+                err += dy;
+            }
+        }
+    }
+}
+
+// the points of the midpoint circle, in one octant
+template< typename F >
+static void octant(int radius, F f){
+    int x = 0, y = radius, d = 1 - radius;
+    while(x <= y){
+        f(x, y);
+        if(d < 0){
+            d += 2 * x + 3;
+        }else{
+            d += 2 * (x - y) + 5;
+            y--;
+        }
+        x++;
+    }
+}
+
+static void reference_circle(hwlib::window & w, hwlib::xy c, int radius){
+    octant(radius, [&](int x, int y){
+        plot(w, c.x + x, c.y + y); plot(w, c.x - x, c.y + y);
+        plot(w, c.x + x, c.y - y); plot(w, c.x - x, c.y - y);
+        plot(w, c.x + y, c.y + x); plot(w, c.x - y, c.y + x);
+        plot(w, c.x + y, c.y - x); plot(w, c.x - y, c.y - x);
+    });
+}
+
+// every row from the leftmost to the rightmost point of the outline
+static void reference_fill_circle(hwlib::window & w, hwlib::xy c, int radius){
+    static int half[2 * 130 + 1];
+    for(int dy = -radius; dy <= radius; dy++){
+        half[dy + radius] = -1;
+    }
+    auto widen = [&](int dy, int dx){
+        if(dx > half[dy + radius]){
+            half[dy + radius] = dx;
+        }
+    };
+    octant(radius, [&](int x, int y){
+        widen(y, x); widen(-y, x); widen(x, y); widen(-x, y);
+    });
+    for(int dy = -radius; dy <= radius; dy++){
+        for(int dx = -half[dy + radius]; dx <= half[dy + radius]; dx++){
+            plot(w, c.x + dx, c.y + dy);
+        }
+    }
+}
+
+// every row from the leftmost to the rightmost point where an edge
+// crosses it, each edge stepped from its top end (x rounded towards it)
+static void reference_fill_triangle(hwlib::window & w, hwlib::xy a, hwlib::xy b, hwlib::xy c){
+    const hwlib::xy corners[3] = { a, b, c };
+    int top = a.y < b.y ? (a.y < c.y ? a.y : c.y) : (b.y < c.y ? b.y : c.y);
+    int bottom = a.y > b.y ? (a.y > c.y ? a.y : c.y) : (b.y > c.y ? b.y : c.y);
+    for(int y = top; y <= bottom; y++){
+        int left = 1 << 30, right = -(1 << 30);
+        auto cover = [&](int x){
+            left = x < left ? x : left;
+            right = x > right ? x : right;
+        };
+        for(int i = 0; i < 3; i++){
+            hwlib::xy p = corners[i], q = corners[(i + 1) % 3];
+            if(p.y > q.y){
+                auto t = p; p = q; q = t;
+            }
+            if(y < p.y || y > q.y){
+                continue;
+            }
+            if(p.y == q.y){
+                cover(p.x);
+                cover(q.x);
+            }else{
+                cover(p.x + (q.x - p.x) * (y - p.y) / (q.y - p.y));
+            }
+        }
+        for(int x = left; x <= right; x++){
+            plot(w, x, y);
+        }
+    }
+}
+
+// the four corner circles and the two bands between them, the radius
+// limited so that the corner circles fit
+static void reference_fill_round_rect(hwlib::window & w, hwlib::xy pos, hwlib::xy size, int radius){
+    if(size.x <= 0 || size.y <= 0){
+        return;
+    }
+    int shortest = size.x < size.y ? size.x : size.y;
+    radius = radius < 0 ? 0 : radius;
+    radius = radius > (shortest - 1) / 2 ? (shortest - 1) / 2 : radius;
+    int x0 = pos.x + radius, x1 = pos.x + size.x - 1 - radius;
+    int y0 = pos.y + radius, y1 = pos.y + size.y - 1 - radius;
+    for(int y = y0; y <= y1; y++){
+        for(int x = pos.x; x < pos.x + size.x; x++){
+            plot(w, x, y);
+        }
+    }
+    for(int y = pos.y; y < pos.y + size.y; y++){
+        for(int x = x0; x <= x1; x++){
+            plot(w, x, y);
+        }
+    }
+    reference_fill_circle(w, hwlib::xy(x0, y0), radius);
+    reference_fill_circle(w, hwlib::xy(x1, y0), radius);
+    reference_fill_circle(w, hwlib::xy(x0, y1), radius);
+    reference_fill_circle(w, hwlib::xy(x1, y1), radius);
+}
+
+////////////////////////////////////////////////////////////////////////
+
+struct line_case {
+    hwlib::xy a, b;
+};
+
+struct circle_case {
+    hwlib::xy c;
+    int radius;
+};
+
+static const line_case lines[] = {
+    { { 0, 0 }, { 129, 128 } },
+    { { 120, 3 }, { 5, 100 } },
+    { { 64, 64 }, { 64, 64 } },
+    { { 2, 40 }, { 127, 40 } },
+    { { 90, 120 }, { 90, 1 } },
+    { { 10, 0 }, { 13, 128 } },
+    { { 100, 17 }, { 3, 22 } },
+    { { -20, -5 }, { 150, 140 } },
+    { { 140, 10 }, { -7, 60 } },
+};
+
+struct triangle_case {
+    hwlib::xy a, b, c;
+};
+
+struct round_rect_case {
+    hwlib::xy pos, size;
+    int radius;
+};
+
+static const triangle_case triangles[] = {
+    { { 10, 10 }, { 100, 30 }, { 40, 120 } },
+    { { 64, 2 }, { 3, 127 }, { 126, 127 } },
+    // flat top and flat bottom
+    { { 20, 20 }, { 90, 20 }, { 50, 80 } },
+    { { 50, 10 }, { 10, 70 }, { 110, 70 } },
+    // thin, and one row high
+    { { 5, 5 }, { 120, 9 }, { 6, 7 } },
+    { { 30, 60 }, { 80, 60 }, { 55, 60 } },
+    // degenerate: one point, a vertical and a diagonal line
+    { { 64, 64 }, { 64, 64 }, { 64, 64 } },
+    { { 70, 10 }, { 70, 100 }, { 70, 40 } },
+    { { 0, 0 }, { 60, 60 }, { 120, 120 } },
+    // clipped at every side, and with all corners outside
+    { { -40, 30 }, { 60, -50 }, { 100, 90 } },
+    { { 20, 100 }, { 170, 110 }, { 90, 200 } },
+    { { -100, -100 }, { 250, -20 }, { 60, 260 } },
+    // outside the window
+    { { 140, 10 }, { 200, 20 }, { 160, 90 } },
+};
+
+static const round_rect_case round_rects[] = {
+    { { 10, 10 }, { 60, 40 }, 8 },
+    { { 10, 10 }, { 61, 41 }, 8 },
+    // even and odd sizes with the largest radius
+    { { 20, 20 }, { 10, 10 }, 5 },
+    { { 20, 20 }, { 11, 11 }, 5 },
+    { { 20, 20 }, { 30, 12 }, 100 },
+    { { 20, 20 }, { 31, 13 }, 100 },
+    // no radius, a negative radius, one pixel, two pixels, nothing
+    { { 50, 50 }, { 20, 20 }, 0 },
+    { { 50, 50 }, { 20, 20 }, -3 },
+    { { 64, 64 }, { 1, 1 }, 4 },
+    { { 64, 64 }, { 2, 1 }, 4 },
+    { { 64, 64 }, { 0, 10 }, 4 },
+    // clipped
+    { { -15, -10 }, { 50, 40 }, 12 },
+    { { 100, 90 }, { 50, 60 }, 20 },
+    { { -20, 30 }, { 180, 60 }, 25 },
+};
+
+static const circle_case circles[] = {
+    { { 64, 64 }, 0 }, { { 64, 64 }, 1 }, { { 30, 30 }, 3 }, { { 70, 40 }, 10 },
+    { { 64, 64 }, 60 }, { { 5, 5 }, 20 }, { { 125, 120 }, 33 },
+};
+
+void check_raster(){
+    static simulated_panel span_panel, pixel_panel;
+    ILI9163_display span(span_panel.bus, hwlib::pin_out_dummy, span_panel.wrx(), hwlib::pin_out_dummy);
+    ILI9163_display pixel(pixel_panel.bus, hwlib::pin_out_dummy, pixel_panel.wrx(), hwlib::pin_out_dummy);
+    CHECK( rgb565_from_color(ink_color) == ink );
+
+    auto start = [&](){
+        span.clear(hwlib::white);
+        pixel.clear(hwlib::white);
+        span_panel.bus.clear_count();
+        pixel_panel.bus.clear_count();
+    };
+
+    for(auto & l : lines){
+        start();
+        ILI9163_line(span, l.a, l.b, ink);
+        reference_line(pixel, l.a, l.b);
+        CHECK( span_panel.same(pixel_panel) );
+
+        // hwlib::line on the same display sends more
+        size_t bytes = span_panel.bus.bytes();
+        span_panel.bus.clear_count();
+        hwlib::line(l.a, l.b, ink_color).draw(span);
+        CHECK( bytes <= span_panel.bus.bytes() );
+    }
+
+    for(auto & c : circles){
+        start();
+        ILI9163_circle(span, c.c, c.radius, ink);
+        reference_circle(pixel, c.c, c.radius);
+        CHECK( span_panel.same(pixel_panel) );
+
+        size_t bytes = span_panel.bus.bytes();
+        span_panel.bus.clear_count();
+        hwlib::circle(c.c, c.radius, ink_color).draw(span);
+        CHECK( c.radius < 3 || bytes < span_panel.bus.bytes() );
+
+        start();
+        ILI9163_fill_circle(span, c.c, c.radius, ink);
+        reference_fill_circle(pixel, c.c, c.radius);
+        CHECK( span_panel.same(pixel_panel) );
+    }
+
+    // the triangles in every order of the corners
+    for(auto & t : triangles){
+        const hwlib::xy orders[6][3] = {
+            { t.a, t.b, t.c }, { t.a, t.c, t.b }, { t.b, t.a, t.c },
+            { t.b, t.c, t.a }, { t.c, t.a, t.b }, { t.c, t.b, t.a },
+        };
+        for(auto & o : orders){
+            start();
+            ILI9163_fill_triangle(span, o[0], o[1], o[2], ink);
+            reference_fill_triangle(pixel, t.a, t.b, t.c);
+            CHECK( span_panel.same(pixel_panel) );
+        }
+    }
+
+    for(auto & r : round_rects){
+        start();
+        ILI9163_fill_round_rect(span, r.pos, r.size, r.radius, ink);
+        reference_fill_round_rect(pixel, r.pos, r.size, r.radius);
+        CHECK( span_panel.same(pixel_panel) );
+    }
+}
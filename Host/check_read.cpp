@@ -0,0 +1,92 @@
+#include "check.hpp"
+#include "ILI9163_canvas.hpp"
+#include "ILI9163_rgb565.hpp"
+
+// read_rect against write_rect through the simulated controller:
+// the dummy byte, the 18 bit to 16 bit unpacking and the windows
+
+////////////////////////////////////////////////////////////////////////
+
+// write a pattern at pos, read it back and compare, dst is wider than the
+// block to check the stride and that nothing outside the block is written
+static void round_trip(ILI9163_spi_res_wrx_cs & display, hwlib::xy pos, hwlib::xy size, uint32_t seed){
+    static uint16_t src[130 * 129];
+    static uint16_t dst[140 * 140];
+    const int stride = size.x + 3;
+
+    for(int i = 0; i < size.x * size.y; i++){
+        src[i] = test_pixel(seed, i);
+    }
+    for(auto & p : dst){
+        p = 0xdead;
+    }
+
+    display.write_rect(pos, size, src, size.x);
+    display.read_rect(pos, size, dst, stride);
+
+    bool same = true;
+    bool outside = true;
+    for(int y = 0; y < size.y; y++){
+        for(int x = 0; x < stride; x++){
+            if(x < size.x){
+                same = same && dst[x + stride * y] == src[x + size.x * y];
+            }else{
+                outside = outside && dst[x + stride * y] == 0xdead;
+            }
+        }
+    }
+    CHECK( same );
+    CHECK( outside );
+}
+
+void check_read(){
+    simulated_panel panel;
+    ILI9163_display display(panel.bus, hwlib::pin_out_dummy, panel.wrx(), hwlib::pin_out_dummy);
+
+    // the whole window, a block wider than one read chunk of 16 pixels,
+    // and blocks at the right and bottom edge down to a single pixel
+    round_trip(display, hwlib::xy(0, 0), hwlib::xy(130, 129), 1);
+    round_trip(display, hwlib::xy(3, 5), hwlib::xy(17, 4), 2);
+    round_trip(display, hwlib::xy(113, 120), hwlib::xy(17, 9), 3);
+    round_trip(display, hwlib::xy(129, 0), hwlib::xy(1, 129), 4);
+    round_trip(display, hwlib::xy(0, 128), hwlib::xy(130, 1), 5);
+    round_trip(display, hwlib::xy(129, 128), hwlib::xy(1, 1), 6);
+
+    // a window inside a block that was written as a whole
+    static uint16_t all[130 * 129];
+    static uint16_t part[5 * 3];
+    for(int i = 0; i < 130 * 129; i++){
+        all[i] = test_pixel(7, i);
+    }
+    display.write_rect(hwlib::xy(0, 0), hwlib::xy(130, 129), all, 130);
+    display.read_rect(hwlib::xy(125, 126), hwlib::xy(5, 3), part, 5);
+    bool same = true;
+    for(int y = 0; y < 3; y++){
+        for(int x = 0; x < 5; x++){
+            same = same && part[x + 5 * y] == all[125 + x + 130 * (126 + y)];
+        }
+    }
+    CHECK( same );
+
+    // the canvas saves what is under it, restores it and blends onto it
+    ILI9163_static_canvas< 20, 10 > under;
+    ILI9163_static_canvas< 20, 10 > sprite;
+    under.read(display, hwlib::xy(115, 122));
+    sprite.clear(hwlib::red);
+    sprite.draw(display, hwlib::xy(115, 122));
+    CHECK( panel.chip.pixel(hwlib::xy(129, 128)) == rgb565_from_color(hwlib::red) );
+    under.draw(display, hwlib::xy(115, 122));
+    CHECK( panel.chip.pixel(hwlib::xy(129, 128)) == all[129 + 130 * 128] );
+    CHECK( panel.chip.pixel(hwlib::xy(115, 122)) == all[115 + 130 * 122] );
+
+    // blending: 0 keeps the display, 255 gives the canvas, 128 the 50 % mix
+    sprite.blend(display, hwlib::xy(115, 122), 0);
+    CHECK( panel.chip.pixel(hwlib::xy(120, 125)) == all[120 + 130 * 125] );
+    sprite.blend(display, hwlib::xy(115, 122), 128);
+    uint16_t mixed = all[120 + 130 * 125];
+    uint16_t red = rgb565_from_color(hwlib::red);
+    rgb565_blend50(&mixed, &red, 1);
+    CHECK( panel.chip.pixel(hwlib::xy(120, 125)) == mixed );
+    sprite.blend(display, hwlib::xy(115, 122), 255);
+    CHECK( panel.chip.pixel(hwlib::xy(120, 125)) == red );
+}
@@ -0,0 +1,301 @@
+#include "check.hpp"
+#include "rgb565_kernels.hpp"
+#include "ILI9163_rgb565.hpp"
+#include <cmath>
+
+// the word and SIMD kernels against one pixel at a time references,
+// for every length up to a few SIMD registers and every start alignment
+// of dst and src, with a guard area behind every buffer
+
+////////////////////////////////////////////////////////////////////////
+
+const rgb565_kernels library_kernels = {
+    "library",
+    rgb565_fill,
+    rgb565_fill_rect,
+    rgb565_copy,
+    rgb565_copy_rect,
+    rgb565_keyed_copy,
+    rgb565_blend50,
+    rgb565_blend,
+    rgb565_gradient_h,
+    rgb565_gradient_v,
+};
+
+static void reference_fill(uint16_t * dst, size_t n, uint16_t colour){
+    for(size_t i = 0; i < n; i++){
+        dst[i] = colour;
+    }
+}
+
+static void reference_fill_rect(uint16_t * dst, int stride, int w, int h, uint16_t colour){
+    for(int y = 0; y < h; y++){
+        reference_fill(dst + y * stride, w, colour);
+    }
+}
+
+static void reference_copy(uint16_t * dst, const uint16_t * src, size_t n){
+    for(size_t i = 0; i < n; i++){
+        dst[i] = src[i];
+    }
+}
+
+static void reference_copy_rect(uint16_t * dst, int dst_stride, const uint16_t * src, int src_stride, int w, int h){
+    for(int y = 0; y < h; y++){
+        reference_copy(dst + y * dst_stride, src + y * src_stride, w);
+    }
+}
+
+static void reference_keyed_copy(uint16_t * dst, const uint16_t * src, size_t n, uint16_t key){
+    for(size_t i = 0; i < n; i++){
+        if(src[i] != key){
+            dst[i] = src[i];
+        }
+    }
+}
+
+// the fields of a pixel: shift and mask, high to low
+static const int field_shift[3] = { 11, 5, 0 };
+static const int field_mask[3] = { 0x1f, 0x3f, 0x1f };
+
+static void reference_blend50(uint16_t * dst, const uint16_t * src, size_t n){
+    for(size_t i = 0; i < n; i++){
+        int p = 0;
+        for(int f = 0; f < 3; f++){
+            int d = (dst[i] >> field_shift[f]) & field_mask[f];
+            int s = (src[i] >> field_shift[f]) & field_mask[f];
+            p |= ((d + s) / 2) << field_shift[f];
+        }
+        dst[i] = (uint16_t) p;
+    }
+}
+
+static void reference_blend(uint16_t * dst, const uint16_t * src, size_t n, uint8_t alpha){
+    // alpha in 1/32 steps, rounded
+    int a = (alpha + 4) >> 3;
+    for(size_t i = 0; i < n; i++){
+        int p = 0;
+        for(int f = 0; f < 3; f++){
+            int d = (dst[i] >> field_shift[f]) & field_mask[f];
+            int s = (src[i] >> field_shift[f]) & field_mask[f];
+            // rounded down, also when s < d
+            int mix = d + ((s - d) * a + 32 * 64) / 32 - 64;
+            p |= mix << field_shift[f];
+        }
+        dst[i] = (uint16_t) p;
+    }
+}
+
+// pixel i of n from from to to, each field rounded to the nearest level
+// on its own, a level exactly half way is rounded up
+static uint16_t reference_ramp(uint16_t from, uint16_t to, int i, int n){
+    int p = 0;
+    for(int f = 0; f < 3; f++){
+        int a = (from >> field_shift[f]) & field_mask[f];
+        int b = (to >> field_shift[f]) & field_mask[f];
+        int mix = a;
+        if(n > 1){
+            // a + (b - a) * i / (n - 1) + 1 / 2, rounded down, in doubles: exact for these sizes
+            mix = (int) std::floor(a + (double) ((b - a) * i) / (n - 1) + 0.5);
+        }
+        p |= mix << field_shift[f];
+    }
+    return (uint16_t) p;
+}
+
+static void reference_gradient_h(uint16_t * dst, int stride, int w, int h, uint16_t from, uint16_t to){
+    for(int y = 0; y < h; y++){
+        for(int x = 0; x < w; x++){
+            dst[x + y * stride] = reference_ramp(from, to, x, w);
+        }
+    }
+}
+
+static void reference_gradient_v(uint16_t * dst, int stride, int w, int h, uint16_t from, uint16_t to){
+    for(int y = 0; y < h; y++){
+        for(int x = 0; x < w; x++){
+            dst[x + y * stride] = reference_ramp(from, to, y, h);
+        }
+    }
+}
+
+const rgb565_kernels reference_kernels = {
+    "reference",
+    reference_fill,
+    reference_fill_rect,
+    reference_copy,
+    reference_copy_rect,
+    reference_keyed_copy,
+    reference_blend50,
+    reference_blend,
+    reference_gradient_h,
+    reference_gradient_v,
+};
+
+////////////////////////////////////////////////////////////////////////
+
+static const int guard = 24;
+static const int max_offset = 8;
+static const int max_length = 40;
+static const int buffer_size = max_offset + max_length + guard;
+
+// the kernel and the reference on equal buffers, true when the whole
+// buffers are equal afterwards, including the guard area
+template< typename F >
+static bool same_result(const rgb565_kernels & k, uint32_t seed, F run){
+    alignas( 16 ) static uint16_t dst[buffer_size];
+    alignas( 16 ) static uint16_t src[buffer_size];
+    alignas( 16 ) static uint16_t expect[buffer_size];
+    for(int i = 0; i < buffer_size; i++){
+        dst[i] = expect[i] = test_pixel(seed, i);
+        // every fourth pixel is the key of the keyed copies
+        src[i] = i % 4 == 1 ? 0xf81f : test_pixel(seed + 1000, i);
+    }
+    run(k, dst, src);
+    run(reference_kernels, expect, src);
+    for(int i = 0; i < buffer_size; i++){
+        if(dst[i] != expect[i]){
+            return false;
+        }
+    }
+    return true;
+}
+
+static void check_kernels(const rgb565_kernels & k){
+    static const uint8_t alphas[] = { 0, 3, 4, 37, 100, 127, 128, 200, 251, 252, 255 };
+    bool fill = true, copy = true, keyed = true, blend50 = true, blend = true;
+
+    for(int n = 0; n <= max_length; n++){
+        for(int d = 0; d < max_offset; d++){
+            uint32_t seed = n * 64 + d * 8;
+            fill = fill && same_result(k, seed, [&](const rgb565_kernels & k, uint16_t * dst, uint16_t *){
+                k.fill(dst + d, n, 0x1234);
+            });
+            for(int s = 0; s < max_offset; s++){
+                copy = copy && same_result(k, seed + s, [&](const rgb565_kernels & k, uint16_t * dst, uint16_t * src){
+                    k.copy(dst + d, src + s, n);
+                });
+                keyed = keyed && same_result(k, seed + s, [&](const rgb565_kernels & k, uint16_t * dst, uint16_t * src){
+                    k.keyed_copy(dst + d, src + s, n, 0xf81f);
+                });
+                blend50 = blend50 && same_result(k, seed + s, [&](const rgb565_kernels & k, uint16_t * dst, uint16_t * src){
+                    k.blend50(dst + d, src + s, n);
+                });
+                for(auto alpha : alphas){
+                    blend = blend && same_result(k, seed + s + alpha, [&](const rgb565_kernels & k, uint16_t * dst, uint16_t * src){
+                        k.blend(dst + d, src + s, n, alpha);
+                    });
+                }
+            }
+        }
+    }
+    CHECK( fill );
+    CHECK( copy );
+    CHECK( keyed );
+    CHECK( blend50 );
+    CHECK( blend );
+
+    // rectangles with and without padding between the rows
+    bool rects = true;
+    static const int sizes[][4] = {
+        // w, h, dst stride, src stride
+        { 5, 3, 5, 5 }, { 5, 3, 7, 5 }, { 9, 4, 9, 11 }, { 17, 2, 19, 20 }, { 1, 5, 3, 2 }, { 0, 3, 4, 4 },
+    };
+    for(auto & r : sizes){
+        for(int d = 0; d < 4; d++){
+            rects = rects && same_result(k, r[0] + d, [&](const rgb565_kernels & k, uint16_t * dst, uint16_t *){
+                k.fill_rect(dst + d, r[2], r[0], r[1], 0x4321);
+            });
+            rects = rects && same_result(k, r[1] + d, [&](const rgb565_kernels & k, uint16_t * dst, uint16_t * src){
+                k.copy_rect(dst + d, r[2], src + 1, r[3], r[0], r[1]);
+            });
+        }
+    }
+    CHECK( rects );
+}
+
+// the gradients on a 140 x 140 buffer against the references, and
+// rectangles without pixels that must leave the buffer alone
+static void check_gradients(const rgb565_kernels & k){
+    static uint16_t dst[140 * 140], expect[140 * 140];
+    static const uint16_t ends[][2] = {
+        { 0x0000, 0xffff }, { 0xffff, 0x0000 }, { 0xf800, 0x07ff }, { 0x1234, 0xfedc }, { 0x4a69, 0x4a69 },
+    };
+    static const int sizes[][3] = {
+        // w, h, stride
+        { 130, 129, 130 }, { 129, 130, 140 }, { 1, 7, 3 }, { 7, 1, 7 }, { 2, 2, 5 }, { 33, 64, 40 }, { 1, 1, 1 },
+    };
+    bool ramps = true, endpoints = true;
+    for(auto & e : ends){
+        for(auto & r : sizes){
+            for(int vertical = 0; vertical < 2; vertical++){
+                for(int i = 0; i < 140 * 140; i++){
+                    dst[i] = expect[i] = test_pixel(r[0] + r[1], i);
+                }
+                auto run = vertical ? &rgb565_kernels::gradient_v : &rgb565_kernels::gradient_h;
+                (k.*run)(dst, r[2], r[0], r[1], e[0], e[1]);
+                (reference_kernels.*run)(expect, r[2], r[0], r[1], e[0], e[1]);
+                for(int i = 0; i < 140 * 140; i++){
+                    ramps = ramps && dst[i] == expect[i];
+                }
+                // the first pixel is from, the last of the ramp is to
+                int last = vertical ? (r[1] - 1) * r[2] : r[0] - 1;
+                endpoints = endpoints && dst[0] == e[0];
+                endpoints = endpoints && (last == 0 || dst[last] == e[1]);
+            }
+        }
+    }
+    CHECK( ramps );
+    CHECK( endpoints );
+
+    bool empty = true;
+    static const int nothing[][2] = { { 0, 5 }, { 5, 0 }, { -5, 3 }, { 3, -5 }, { -1, -1 } };
+    for(auto & r : nothing){
+        for(int i = 0; i < 140 * 140; i++){
+            dst[i] = expect[i] = test_pixel(7, i);
+        }
+        k.gradient_h(dst + 100, 10, r[0], r[1], 0x0000, 0xffff);
+        k.gradient_v(dst + 100, 10, r[0], r[1], 0x0000, 0xffff);
+        k.fill_rect(dst + 100, 10, r[0], r[1], 0xffff);
+        for(int i = 0; i < 140 * 140; i++){
+            empty = empty && dst[i] == expect[i];
+        }
+    }
+    CHECK( empty );
+}
+
+void check_rgb565(){
+    check_kernels(library_kernels);
+    check_kernels(word_kernels);
+    check_gradients(library_kernels);
+    check_gradients(word_kernels);
+
+    // the blends with every pair of field values, in both directions
+    bool fields = true;
+    static uint16_t a[64 * 64], b[64 * 64], c[64 * 64], d[64 * 64];
+    for(int i = 0; i < 64 * 64; i++){
+        int x = i % 64, y = i / 64;
+        a[i] = (uint16_t) ((x / 2) << 11 | x << 5 | (x / 2));
+        b[i] = (uint16_t) ((y / 2) << 11 | y << 5 | (y / 2));
+    }
+    static const rgb565_kernels * const fast[] = { &library_kernels, &word_kernels };
+    for(auto k : fast){
+        for(int alpha = 0; alpha < 256; alpha += 5){
+            reference_copy(c, a, 64 * 64);
+            reference_copy(d, a, 64 * 64);
+            k->blend(c, b, 64 * 64, (uint8_t) alpha);
+            reference_blend(d, b, 64 * 64, (uint8_t) alpha);
+            for(int i = 0; i < 64 * 64; i++){
+                fields = fields && c[i] == d[i];
+            }
+        }
+        reference_copy(c, a, 64 * 64);
+        reference_copy(d, a, 64 * 64);
+        k->blend50(c, b, 64 * 64);
+        reference_blend50(d, b, 64 * 64);
+        for(int i = 0; i < 64 * 64; i++){
+            fields = fields && c[i] == d[i];
+        }
+    }
+    CHECK( fields );
+}
@@ -0,0 +1,56 @@
+#include "check.hpp"
+#include "scenes.hpp"
+#include "ILI9163_rle.hpp"
+
+// the run-length window against the buffered window, flushed to two
+// panels: a game of snake and a dashboard, with enough storage, with raw
+// rows and with so little storage that rows go to the display directly
+
+////////////////////////////////////////////////////////////////////////
+
+using buffered = ILI9163_spi_128x128_buffered_res_wrx_cs;
+
+template< uint8_t RUNS, uint8_t RAW_ROWS >
+static void check_storage(bool expect_raw, bool expect_direct){
+    static simulated_panel rle_panel, buffered_panel;
+    static ILI9163_spi_128x128_rle_storage_res_wrx_cs< RUNS, RAW_ROWS > rle(
+        rle_panel.bus, hwlib::pin_out_dummy, rle_panel.wrx(), hwlib::pin_out_dummy);
+    static buffered frame(buffered_panel.bus, hwlib::pin_out_dummy, buffered_panel.wrx(), hwlib::pin_out_dummy);
+
+    // constructed with one run per row in storage that is already there
+    CHECK( rle.memory_used() == 129 * sizeof(ILI9163_rle_run) );
+
+    snake_scene on_rle(rle, 3);
+    snake_scene on_buffered(frame, 3);
+    bool same = true;
+    for(int i = 0; i < 400 && on_rle.tick() && on_buffered.tick(); i++){
+        if(i % 20 == 0){
+            rle.flush();
+            frame.flush();
+            same = same && rle_panel.same(buffered_panel);
+        }
+    }
+    CHECK( same );
+
+    uint_fast16_t raw = 0, direct = 0;
+    same = true;
+    for(int f = 0; f < 30; f++){
+        draw_dashboard(rle, f);
+        draw_dashboard(frame, f);
+        raw = raw > rle.raw_row_count() ? raw : rle.raw_row_count();
+        direct = direct > rle.direct_row_count() ? direct : rle.direct_row_count();
+        rle.flush();
+        frame.flush();
+        same = same && rle_panel.same(buffered_panel);
+    }
+    CHECK( same );
+    CHECK( (raw > 0) == expect_raw );
+    CHECK( (direct > 0) == expect_direct );
+    CHECK( rle.memory_used() <= rle.memory_reserved() );
+}
+
+void check_rle(){
+    check_storage< 40, 0 >(false, false);
+    check_storage< 16, 64 >(true, false);
+    check_storage< 2, 1 >(true, true);
+}
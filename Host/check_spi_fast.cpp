@@ -0,0 +1,162 @@
+#include "check.hpp"
+#include "ILI9163_spi_fast.hpp"
+#include "ILI9163_rgb565.hpp"
+
+// the bit banged bus at the pin level: a PORT that follows the clock and
+// data pins decodes the bytes into a controller model, so the bit order,
+// the clock phase, the holds between the edges and the fills through
+// write_repeated16 are checked against a display on the simulated bus
+
+////////////////////////////////////////////////////////////////////////
+
+static const uint32_t sclk_pin = 1 << 13;
+static const uint32_t mosi_pin = 1 << 12;
+
+// the pins at the other end of the wires
+struct wire {
+
+    // a pin that remembers its level, for dc and cs
+    class level_pin : public hwlib::pin_out {
+    public:
+        wire & w;
+        bool level = true;
+
+        level_pin(wire & w):
+            w( w )
+        {}
+
+        void write(bool v) override {
+            // the clock idles low when the transaction or data / command changes
+            w.idle_low = w.idle_low && !w.clock;
+            level = v;
+        }
+    };
+
+    ILI9163_simulator chip;
+    level_pin dc, cs;
+    bool clock = false, data = false;
+    uint8_t byte = 0;
+    int bits = 0;
+
+    // the holds since the last data change and since the rising edge
+    bool setup_held = true, high_held = false;
+    bool timing = true, idle_low = true, selected = true;
+    size_t bytes = 0;
+
+    wire():
+        dc( *this ),
+        cs( *this )
+    {}
+
+    void pins(uint32_t mask, bool level){
+        if(mask & mosi_pin){
+            setup_held = setup_held && data == level;
+            data = level;
+        }
+        if((mask & sclk_pin) && level && !clock){
+            // rising edge: sample the data
+            timing = timing && setup_held;
+            selected = selected && !cs.level;
+            byte = byte << 1 | data;
+            if(++bits == 8){
+                if(dc.level){
+                    chip.data(byte);
+                }else{
+                    chip.command(byte);
+                }
+                bits = 0;
+                bytes++;
+            }
+            high_held = false;
+        }
+        if((mask & sclk_pin) && !level && clock){
+            timing = timing && high_held;
+            setup_held = false;
+        }
+        if(mask & sclk_pin){
+            clock = level;
+        }
+    }
+
+    void hold(){
+        setup_held = true;
+        high_held = clock;
+    }
+};
+
+// the PORT of the bus, a copy refers to the same wire
+struct wire_port {
+    wire * w;
+
+    void set(uint32_t mask){
+        w->pins(mask, true);
+    }
+
+    void clear(uint32_t mask){
+        w->pins(mask, false);
+    }
+
+    void hold(){
+        w->hold();
+    }
+};
+
+// counts the fills that come through write_repeated16
+class fill_counting_bus : public ILI9163_spi_bus_bit_banged_sclk_mosi< wire_port > {
+public:
+    int fills = 0;
+
+    fill_counting_bus(wire & w):
+        ILI9163_spi_bus_bit_banged_sclk_mosi< wire_port >(wire_port{ &w }, sclk_pin, mosi_pin)
+    {}
+
+    void write_repeated16(hwlib::pin_out & sel, hwlib::pin_out & dc, uint16_t value, size_t n) override {
+        fills++;
+        ILI9163_spi_bus_bit_banged_sclk_mosi< wire_port >::write_repeated16(sel, dc, value, n);
+    }
+};
+
+void check_spi_fast(){
+    static wire pins;
+    static simulated_panel panel;
+    fill_counting_bus bus(pins);
+    ILI9163_display fast(bus, hwlib::pin_out_dummy, pins.dc, pins.cs);
+    ILI9163_display plain(panel.bus, hwlib::pin_out_dummy, panel.wrx(), hwlib::pin_out_dummy);
+
+    static uint16_t block[40 * 30];
+    for(int i = 0; i < 40 * 30; i++){
+        block[i] = test_pixel(9, i);
+    }
+
+    // the clear and the filled rectangles are fills, the rest single bytes and bursts
+    ILI9163_display * const displays[] = { &fast, &plain };
+    for(auto d : displays){
+        d->clear(hwlib::blue);
+        d->fill_rect(hwlib::xy(3, 4), hwlib::xy(61, 17), 0x1234);
+        d->drawRectFilled(100, 90, 13, 7, 0xa5c3);
+        d->write_rect(hwlib::xy(70, 50), hwlib::xy(40, 30), block, 40);
+        d->write_rect(hwlib::xy(1, 100), hwlib::xy(21, 9), block, 40);
+        d->write(hwlib::xy(129, 128), hwlib::red);
+        d->write(hwlib::xy(0, 0), hwlib::green);
+    }
+    CHECK( bus.fills == 3 );
+    CHECK( pins.bytes == panel.bus.bytes() );
+    CHECK( pins.timing );
+    CHECK( pins.idle_low );
+    CHECK( pins.selected );
+    CHECK( pins.bits == 0 );
+    bool same = true;
+    for(int y = 0; y < 129; y++){
+        for(int x = 0; x < 130; x++){
+            same = same && pins.chip.pixel(hwlib::xy(x, y)) == panel.chip.pixel(hwlib::xy(x, y));
+        }
+    }
+    CHECK( same );
+
+    // an odd count of a value with distinct bytes, high byte first
+    fast.setAddress(0, 0, 129, 128);
+    bus.write_repeated16(pins.cs, pins.dc, 0x80a1, 7);
+    CHECK( pins.chip.pixel(hwlib::xy(6, 0)) == 0x80a1 );
+    CHECK( pins.chip.pixel(hwlib::xy(7, 0)) == rgb565_from_color(hwlib::blue) );
+    CHECK( pins.cs.level );
+}
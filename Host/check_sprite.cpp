@@ -0,0 +1,103 @@
+#include "check.hpp"
+#include "ILI9163_sprite.hpp"
+
+// the sprite layer against a frame composed pixel by pixel:
+// transparency, overlap order, moves that touch and that do not,
+// hiding, a new image and sprites partly off the window
+
+////////////////////////////////////////////////////////////////////////
+
+static const hwlib::xy wsize(130, 129);
+static const uint16_t key = 0xf81f;
+
+static uint16_t background_pixels[130 * 129];
+static uint16_t ball_pixels[8 * 6];
+static uint16_t box_pixels[5 * 5];
+static uint16_t bar_pixels[11 * 2];
+
+// test pixels with a transparent pixel every third one
+static void fill_image(uint16_t pixels[], int n, uint32_t seed){
+    for(int i = 0; i < n; i++){
+        pixels[i] = i % 3 == 0 ? key : test_pixel(seed, i);
+    }
+}
+
+// true when the panel shows the background with the visible sprites on top, in array order
+static bool composed(const simulated_panel & panel, ILI9163_sprite * const sprites[], size_t count){
+    for(int y = 0; y < wsize.y; y++){
+        for(int x = 0; x < wsize.x; x++){
+            uint16_t p = background_pixels[x + 130 * y];
+            for(size_t i = 0; i < count; i++){
+                const ILI9163_sprite & s = *sprites[i];
+                hwlib::xy at = hwlib::xy(x, y) - s.position;
+                if(s.visible && at.x >= 0 && at.y >= 0 && at.x < s.image->size.x && at.y < s.image->size.y){
+                    uint16_t q = s.image->pixels[at.x + s.image->size.x * at.y];
+                    if(q != s.image->key){
+                        p = q;
+                    }
+                }
+            }
+            if(panel.chip.pixel(hwlib::xy(x, y)) != p){
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void check_sprite(){
+    for(int i = 0; i < 130 * 129; i++){
+        background_pixels[i] = test_pixel(1, i);
+    }
+    fill_image(ball_pixels, 8 * 6, 2);
+    fill_image(box_pixels, 5 * 5, 3);
+    fill_image(bar_pixels, 11 * 2, 4);
+
+    static const ILI9163_sprite_image ball = { hwlib::xy(8, 6), key, ball_pixels };
+    static const ILI9163_sprite_image box = { hwlib::xy(5, 5), key, box_pixels };
+    static const ILI9163_sprite_image bar = { hwlib::xy(11, 2), key, bar_pixels };
+
+    simulated_panel panel;
+    ILI9163_display display(panel.bus, hwlib::pin_out_dummy, panel.wrx(), hwlib::pin_out_dummy);
+    ILI9163_image_background background(background_pixels);
+
+    ILI9163_sprite first(ball, hwlib::xy(10, 10));
+    ILI9163_sprite second(box, hwlib::xy(14, 12));
+    ILI9163_sprite * const sprites[] = { &first, &second };
+    ILI9163_sprite_layer layer(display, background, sprites, 2);
+
+    layer.draw();
+    CHECK( composed(panel, sprites, 2) );
+
+    // a move that touches the old area, below the second sprite
+    layer.move(first, hwlib::xy(12, 11));
+    CHECK( composed(panel, sprites, 2) );
+
+    // a move far away, the old area shows the background again
+    layer.move(first, hwlib::xy(90, 70));
+    CHECK( composed(panel, sprites, 2) );
+
+    layer.show(second, false);
+    CHECK( composed(panel, sprites, 2) );
+    layer.show(second, true);
+    CHECK( composed(panel, sprites, 2) );
+
+    // a wider image, then back to a smaller one
+    layer.set_image(second, bar);
+    CHECK( composed(panel, sprites, 2) );
+    layer.set_image(second, box);
+    CHECK( composed(panel, sprites, 2) );
+
+    // partly off the window on every side
+    layer.move(first, hwlib::xy(-3, -2));
+    CHECK( composed(panel, sprites, 2) );
+    layer.move(first, hwlib::xy(125, 125));
+    CHECK( composed(panel, sprites, 2) );
+
+    // hidden sprites move without drawing
+    layer.show(second, false);
+    panel.bus.clear_count();
+    layer.move(second, hwlib::xy(60, 60));
+    CHECK( panel.bus.bytes() == 0 );
+    CHECK( composed(panel, sprites, 2) );
+}
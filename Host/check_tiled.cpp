@@ -0,0 +1,179 @@
+#include "check.hpp"
+#include "ILI9163_tiled.hpp"
+#include "ILI9163_rgb565.hpp"
+
+// a grid of panels against the same drawing on one large image: the
+// stitched output of lines, circles, rectangles and blocks that cross the
+// seams (and the corner where four panels meet), clipping at the outer
+// edges, and flush() only flushing the panels that were written
+
+////////////////////////////////////////////////////////////////////////
+
+static const hwlib::xy panel_size(130, 129);
+
+// the whole tiled area in memory, 16 bit pixels as the panels store them
+template< int COLUMNS, int ROWS >
+class reference_image : public hwlib::window {
+private:
+    uint16_t pixels[COLUMNS * 130 * ROWS * 129];
+
+    void write_implementation(hwlib::xy pos, hwlib::color col) override {
+        pixels[pos.x + size.x * pos.y] = rgb565_from_color(col);
+    }
+
+    void clear_implementation(hwlib::color col) override {
+        for(auto & p : pixels){
+            p = rgb565_from_color(col);
+        }
+    }
+
+public:
+    reference_image():
+        window( hwlib::xy(COLUMNS * panel_size.x, ROWS * panel_size.y), hwlib::black, hwlib::white )
+    {}
+
+    uint16_t pixel(hwlib::xy pos) const {
+        return pixels[pos.x + size.x * pos.y];
+    }
+
+    void fill_rect(hwlib::xy pos, hwlib::xy part, hwlib::color col){
+        for(int y = pos.y; y < pos.y + part.y; y++){
+            for(int x = pos.x; x < pos.x + part.x; x++){
+                write(hwlib::xy(x, y), col);
+            }
+        }
+    }
+
+    void write_rect(hwlib::xy pos, hwlib::xy part, const uint16_t * src, int stride){
+        for(int y = 0; y < part.y; y++){
+            for(int x = 0; x < part.x; x++){
+                hwlib::xy at(pos.x + x, pos.y + y);
+                if(at.x >= 0 && at.y >= 0 && at.x < size.x && at.y < size.y){
+                    pixels[at.x + size.x * at.y] = src[x + stride * y];
+                }
+            }
+        }
+    }
+}; // class reference_image
+
+// true when every panel shows its part of the reference
+template< int COLUMNS, int ROWS >
+static bool stitched(simulated_panel (& panels)[COLUMNS * ROWS], const reference_image< COLUMNS, ROWS > & image){
+    for(int row = 0; row < ROWS; row++){
+        for(int column = 0; column < COLUMNS; column++){
+            const auto & chip = panels[row * COLUMNS + column].chip;
+            for(int y = 0; y < panel_size.y; y++){
+                for(int x = 0; x < panel_size.x; x++){
+                    hwlib::xy at(column * panel_size.x + x, row * panel_size.y + y);
+                    if(chip.pixel(hwlib::xy(x, y)) != image.pixel(at)){
+                        return false;
+                    }
+                }
+            }
+        }
+    }
+    return true;
+}
+
+static uint16_t block[70 * 50];
+
+// the same drawing on the tiled window and on the reference
+template< typename WINDOW, typename IMAGE >
+static void draw(WINDOW & w, IMAGE & image){
+    const hwlib::color red(255, 0, 0), green(0, 255, 0), blue(0, 0, 255);
+    hwlib::xy corner = panel_size;
+
+    hwlib::window * targets[] = { &w, &image };
+    for(auto t : targets){
+        t->clear(hwlib::color(10, 20, 30));
+        // across the vertical seam, along it, and through the corner
+        hwlib::line(hwlib::xy(100, 40), hwlib::xy(170, 45), red).draw(*t);
+        hwlib::line(hwlib::xy(129, 0), hwlib::xy(129, 257), green).draw(*t);
+        hwlib::line(hwlib::xy(0, 0), hwlib::xy(259, 257), blue).draw(*t);
+        hwlib::line(hwlib::xy(259, 0), hwlib::xy(0, 257), red).draw(*t);
+        // centred on the corner, and partly outside the window
+        hwlib::circle(corner, 40, green).draw(*t);
+        hwlib::circle(hwlib::xy(250, 10), 30, blue).draw(*t);
+        hwlib::rectangle(corner - hwlib::xy(60, 60), corner + hwlib::xy(60, 60), hwlib::white).draw(*t);
+        // the pixels on either side of the corner
+        t->write(corner - hwlib::xy(1, 1), red);
+        t->write(corner, blue);
+    }
+
+    // over the corner, over the outer edges, and one pixel wide on a seam
+    w.fill_rect(corner - hwlib::xy(20, 15), hwlib::xy(41, 31), red);
+    image.fill_rect(corner - hwlib::xy(20, 15), hwlib::xy(41, 31), red);
+    w.fill_rect(hwlib::xy(-10, 120), hwlib::xy(30, 20), green);
+    image.fill_rect(hwlib::xy(-10, 120), hwlib::xy(30, 20), green);
+    w.fill_rect(hwlib::xy(240, 250), hwlib::xy(50, 50), blue);
+    image.fill_rect(hwlib::xy(240, 250), hwlib::xy(50, 50), blue);
+    w.fill_rect(hwlib::xy(130, 60), hwlib::xy(1, 100), hwlib::white);
+    image.fill_rect(hwlib::xy(130, 60), hwlib::xy(1, 100), hwlib::white);
+
+    // a block over the corner, and one clipped at the top left
+    w.write_rect(corner - hwlib::xy(35, 25), hwlib::xy(70, 50), block, 70);
+    image.write_rect(corner - hwlib::xy(35, 25), hwlib::xy(70, 50), block, 70);
+    w.write_rect(hwlib::xy(-7, -5), hwlib::xy(30, 20), block, 70);
+    image.write_rect(hwlib::xy(-7, -5), hwlib::xy(30, 20), block, 70);
+}
+
+void check_tiled(){
+    for(int i = 0; i < 70 * 50; i++){
+        block[i] = test_pixel(21, i);
+    }
+
+    // 2 x 2 direct panels
+    {
+        static simulated_panel panels[4];
+        static ILI9163_display d0(panels[0].bus, hwlib::pin_out_dummy, panels[0].wrx(), hwlib::pin_out_dummy);
+        static ILI9163_display d1(panels[1].bus, hwlib::pin_out_dummy, panels[1].wrx(), hwlib::pin_out_dummy);
+        static ILI9163_display d2(panels[2].bus, hwlib::pin_out_dummy, panels[2].wrx(), hwlib::pin_out_dummy);
+        static ILI9163_display d3(panels[3].bus, hwlib::pin_out_dummy, panels[3].wrx(), hwlib::pin_out_dummy);
+        ILI9163_tiled_window< ILI9163_display, 2, 2 > w({ &d0, &d1, &d2, &d3 });
+        static reference_image< 2, 2 > image;
+        CHECK( w.size == hwlib::xy(260, 258) );
+
+        draw(w, image);
+        CHECK( stitched(panels, image) );
+    }
+
+    // 3 x 1 buffered panels: nothing shows before the flush, a flush only
+    // sends to the panels that were written
+    {
+        using buffered = ILI9163_spi_128x128_buffered_res_wrx_cs;
+        static simulated_panel panels[3];
+        static buffered b0(panels[0].bus, hwlib::pin_out_dummy, panels[0].wrx(), hwlib::pin_out_dummy);
+        static buffered b1(panels[1].bus, hwlib::pin_out_dummy, panels[1].wrx(), hwlib::pin_out_dummy);
+        static buffered b2(panels[2].bus, hwlib::pin_out_dummy, panels[2].wrx(), hwlib::pin_out_dummy);
+        ILI9163_tiled_window< buffered, 3, 1 > w({ &b0, &b1, &b2 });
+        static reference_image< 3, 1 > image;
+        CHECK( w.size == hwlib::xy(390, 129) );
+
+        image.clear(hwlib::black);
+        w.clear(hwlib::black);
+        w.flush();
+        CHECK( stitched(panels, image) );
+
+        // a line over both seams and a block over the second
+        const hwlib::color red(255, 0, 0);
+        hwlib::line(hwlib::xy(5, 3), hwlib::xy(385, 120), red).draw(w);
+        hwlib::line(hwlib::xy(5, 3), hwlib::xy(385, 120), red).draw(image);
+        w.write_rect(hwlib::xy(240, 30), hwlib::xy(40, 20), block, 70);
+        image.write_rect(hwlib::xy(240, 30), hwlib::xy(40, 20), block, 70);
+        CHECK( !stitched(panels, image) );
+        w.flush();
+        CHECK( stitched(panels, image) );
+
+        // only the last panel was written
+        for(auto & p : panels){
+            p.bus.clear_count();
+        }
+        w.fill_rect(hwlib::xy(300, 100), hwlib::xy(20, 10), hwlib::white);
+        image.fill_rect(hwlib::xy(300, 100), hwlib::xy(20, 10), hwlib::white);
+        w.flush();
+        CHECK( panels[0].bus.bytes() == 0 );
+        CHECK( panels[1].bus.bytes() == 0 );
+        CHECK( panels[2].bus.bytes() > 0 );
+        CHECK( stitched(panels, image) );
+    }
+}
@@ -0,0 +1,77 @@
+#include "hwlib.hpp"
+#include "check.hpp"
+#include "bench.hpp"
+#include <cstdio>
+#include <string>
+
+// Host checks of the ILI9163 library against the controller model.
+//
+//   host          run all checks, the exit code is the number of failures
+//   host bench    run the benchmarks, host time with a bus that only counts
+
+////////////////////////////////////////////////////////////////////////
+
+static int checks = 0;
+static int failures = 0;
+
+bool check_that(bool condition, const char * text, const char * file, int line){
+    checks++;
+    if(!condition){
+        failures++;
+        if(failures <= 20){
+            std::printf("%s:%d: check failed: %s\n", file, line, text);
+        }
+    }
+    return condition;
+}
+
+struct named_check {
+    const char * name;
+    void (* run)();
+};
+
+static const named_check all_checks[] = {
+    { "canvas", check_canvas },
+    { "display_list", check_display_list },
+    { "flush", check_flush },
+    { "game", check_game },
+    { "image", check_image },
+    { "input", check_input },
+    { "lut", check_lut },
+    { "power", check_power },
+    { "raster", check_raster },
+    { "read",  check_read },
+    { "rgb565", check_rgb565 },
+    { "rle", check_rle },
+    { "spi_fast", check_spi_fast },
+    { "sprite", check_sprite },
+    { "tiled", check_tiled },
+};
+
+static const named_check all_benches[] = {
+    { "raster", bench_raster },
+    { "rgb565", bench_rgb565 },
+    { "rle", bench_rle },
+    { "sprite", bench_sprite },
+    { "tiles", bench_tiles },
+};
+
+////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char * argv[]){
+    if(argc > 1 && std::string(argv[1]) == "bench"){
+        for(const auto & b : all_benches){
+            std::printf("%s\n", b.name);
+            b.run();
+        }
+        return 0;
+    }
+
+    for(const auto & c : all_checks){
+        int before = failures;
+        c.run();
+        std::printf("%-14s %s\n", c.name, failures == before ? "ok" : "FAILED");
+    }
+    std::printf("%d checks, %d failed\n", checks, failures);
+    return failures > 255 ? 255 : failures;
+}
@@ -0,0 +1,35 @@
+#ifndef RGB565_KERNELS_HPP
+#define RGB565_KERNELS_HPP
+
+#include <cstdint>
+#include <cstddef>
+
+////////////////////////////////////////////////////////////////////////
+
+// one set of the rgb565 kernels, so the checks and the benchmarks run
+// the same code on every set
+struct rgb565_kernels {
+    const char * name;
+    void (* fill)(uint16_t * dst, size_t n, uint16_t colour);
+    void (* fill_rect)(uint16_t * dst, int stride, int w, int h, uint16_t colour);
+    void (* copy)(uint16_t * dst, const uint16_t * src, size_t n);
+    void (* copy_rect)(uint16_t * dst, int dst_stride, const uint16_t * src, int src_stride, int w, int h);
+    void (* keyed_copy)(uint16_t * dst, const uint16_t * src, size_t n, uint16_t key);
+    void (* blend50)(uint16_t * dst, const uint16_t * src, size_t n);
+    void (* blend)(uint16_t * dst, const uint16_t * src, size_t n, uint8_t alpha);
+    void (* gradient_h)(uint16_t * dst, int stride, int w, int h, uint16_t from, uint16_t to);
+    void (* gradient_v)(uint16_t * dst, int stride, int w, int h, uint16_t from, uint16_t to);
+};
+
+// the kernels as linked, SSE2 or NEON on hosts that have them
+extern const rgb565_kernels library_kernels;
+
+// the 32 bit word kernels the Due runs
+extern const rgb565_kernels word_kernels;
+
+// one pixel and one colour field at a time
+extern const rgb565_kernels reference_kernels;
+
+////////////////////////////////////////////////////////////////////////
+
+#endif //RGB565_KERNELS_HPP
@@ -0,0 +1,26 @@
+#include "rgb565_kernels.hpp"
+#include "ILI9163_rgb565.hpp"
+
+// A second copy of the library kernels, built without SSE2 or NEON so the
+// host checks the word paths of the Due too. The copy is in its own
+// namespace, the header is already included so only the definitions are.
+
+////////////////////////////////////////////////////////////////////////
+
+namespace words {
+#define ILI9163_RGB565_WORDS
+#include "ILI9163_rgb565.cpp"
+}
+
+const rgb565_kernels word_kernels = {
+    "words",
+    words::rgb565_fill,
+    words::rgb565_fill_rect,
+    words::rgb565_copy,
+    words::rgb565_copy_rect,
+    words::rgb565_keyed_copy,
+    words::rgb565_blend50,
+    words::rgb565_blend,
+    words::rgb565_gradient_h,
+    words::rgb565_gradient_v,
+};
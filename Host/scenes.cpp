@@ -0,0 +1,58 @@
+#include "scenes.hpp"
+
+////////////////////////////////////////////////////////////////////////
+
+snake_scene::snake_scene(hwlib::window & w, uint32_t seed):
+    rnd( seed ),
+    g( w, rnd ),
+    player( g )
+{
+    w.clear(hwlib::white);
+    g.draw();
+}
+
+bool snake_scene::tick(){
+    return g.tick(player) == game_state::running;
+}
+
+////////////////////////////////////////////////////////////////////////
+
+static void fill(hwlib::window & w, hwlib::xy pos, hwlib::xy size, hwlib::color col){
+    for(int y = pos.y; y < pos.y + size.y; y++){
+        for(int x = pos.x; x < pos.x + size.x; x++){
+            w.write(hwlib::xy(x, y), col);
+        }
+    }
+}
+
+void draw_dashboard(hwlib::window & w, int frame){
+    static const hwlib::color panel(40, 40, 48);
+    static const hwlib::color bar(0, 200, 80);
+    static const hwlib::color graph(255, 200, 0);
+
+    w.clear(hwlib::black);
+
+    // title bar and two panels
+    fill(w, hwlib::xy(0, 0), hwlib::xy(130, 12), hwlib::blue);
+    fill(w, hwlib::xy(4, 16), hwlib::xy(58, 60), panel);
+    fill(w, hwlib::xy(68, 16), hwlib::xy(58, 60), panel);
+
+    // eight bars
+    for(int i = 0; i < 8; i++){
+        int h = 10 + (frame * (i + 3) + 17 * i) % 45;
+        fill(w, hwlib::xy(8 + 6 * i, 72 - h), hwlib::xy(4, h), bar);
+    }
+
+    // a scrolling line graph
+    hwlib::xy last(70, 46);
+    for(int x = 0; x < 54; x += 3){
+        int v = ((x + frame) * 37 % 50) - 25;
+        hwlib::xy next(70 + x, 46 + v);
+        hwlib::line(last, next, graph).draw(w);
+        last = next;
+    }
+
+    // status line
+    fill(w, hwlib::xy(0, 80), hwlib::xy(130, 49), hwlib::white);
+    fill(w, hwlib::xy(4, 84), hwlib::xy(frame % 122, 6), hwlib::red);
+}
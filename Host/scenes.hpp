@@ -0,0 +1,30 @@
+#ifndef SCENES_HPP
+#define SCENES_HPP
+
+#include "hwlib.hpp"
+#include "game.hpp"
+#include "autopilot.hpp"
+#include "random.hpp"
+
+////////////////////////////////////////////////////////////////////////
+
+// a game of snake played by the autopilot on a window, the same seed
+// always gives the same game
+struct snake_scene {
+    xorshift_random rnd;
+    game g;
+    autopilot player;
+
+    snake_scene(hwlib::window & w, uint32_t seed);
+
+    // one tick of the game, false when the game is over
+    bool tick();
+}; // struct snake_scene
+
+// a dashboard that is redrawn as a whole every frame: flat panels,
+// bars that change height and a line graph that scrolls
+void draw_dashboard(hwlib::window & w, int frame);
+
+////////////////////////////////////////////////////////////////////////
+
+#endif //SCENES_HPP
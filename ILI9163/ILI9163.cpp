@@ -12,6 +12,7 @@
 // ==========================================================================
 
 #include "ILI9163.hpp"
+#include "ILI9163_rgb565.hpp"
 
 ///@file
 
@@ -19,14 +20,16 @@
 ///
 /// construct by providing the spi bus and the res, wrx and cs pins
 ILI9163_spi_res_wrx_cs::ILI9163_spi_res_wrx_cs(hwlib::spi_bus & bus,
-                                               hwlib::target::pin_out & res,
-                                               hwlib::target::pin_out & wrx,
-                                               hwlib::target::pin_out & cs):
+                                               ILI9163_pin_out & res,
+                                               ILI9163_pin_out & wrx,
+                                               ILI9163_pin_out & cs):
     bus( bus ),
     res( res ),
     wrx( wrx ),
     cs( cs ),
-    cursor(255, 255)
+    fill_bus( nullptr ),
+    cursor(255, 255),
+    trace( nullptr )
     {
         res.write( 0 );
         hwlib::wait_ms( 1 );
@@ -35,50 +38,279 @@ ILI9163_spi_res_wrx_cs::ILI9163_spi_res_wrx_cs(hwlib::spi_bus & bus,
         hwlib::wait_ms(20);
     }
 
+/// ILI9163_spi_res_wrx_cs constructor
+///
+/// construct with a bus that sends the fills itself
+ILI9163_spi_res_wrx_cs::ILI9163_spi_res_wrx_cs(ILI9163_fill_spi_bus & bus,
+                                               ILI9163_pin_out & res,
+                                               ILI9163_pin_out & wrx,
+                                               ILI9163_pin_out & cs):
+    ILI9163_spi_res_wrx_cs(static_cast< hwlib::spi_bus & >( bus ), res, wrx, cs)
+{
+    fill_bus = &bus;
+}
+
+/// add a record to the trace, counts above 65535 are split over several records
+void ILI9163_spi_res_wrx_cs::trace_end(uint32_t start, ILI9163_trace_kind kind, uint8_t byte, size_t count, uint16_t value, uint32_t data){
+    if(trace == nullptr){
+        return;
+    }
+    while(count > 0xffff){
+        trace->add(kind, byte, 0xffff, value, start, data);
+        count -= 0xffff;
+        data += 0xffff;
+    }
+    trace->add(kind, byte, count, value, start, data);
+}
+
 /// send a command without data
 void ILI9163_spi_res_wrx_cs::command( ILI9163_commands c ){
-    wrx.write( 0 );
-    wrx.flush();
-    auto t = bus.transaction( cs );
-    t.write( static_cast< uint8_t >( c ) );
+    auto start = trace_start();
+    {
+        wrx.write( 0 );
+        wrx.flush();
+        auto t = bus.transaction( cs );
+        t.write( static_cast< uint8_t >( c ) );
+    }
+    trace_end(start, ILI9163_trace_kind::command, static_cast< uint8_t >( c ), 1, 0);
 }
 
 /// send 8 bit parameter
 void ILI9163_spi_res_wrx_cs::parameter( uint8_t p ){
-    wrx.write(1);
-    wrx.flush();
-    auto t = bus.transaction( cs );
-    t.write( p );
+    auto start = trace_start();
+    {
+        wrx.write(1);
+        wrx.flush();
+        auto t = bus.transaction( cs );
+        t.write( p );
+    }
+    trace_end(start, ILI9163_trace_kind::parameter, p, 1, 0);
 }
 
 /// send 8 bit data
 void ILI9163_spi_res_wrx_cs::data(uint8_t d){
-    wrx.write(1);
-    wrx.flush();
-    auto t = bus.transaction( cs );
-    t.write( d );
+    auto start = trace_start();
+    {
+        wrx.write(1);
+        wrx.flush();
+        auto t = bus.transaction( cs );
+        t.write( d );
+    }
+    trace_end(start, ILI9163_trace_kind::parameter, d, 1, 0);
 }
 
 /// send 16 bit data
 void ILI9163_spi_res_wrx_cs::data16(uint16_t d){
-    wrx.write(1);
-    wrx.flush();
-    auto t = bus.transaction( cs );
-    t.write( (d >> 8) & 0xff );
-    t.write(d & 0xff );
+    auto start = trace_start();
+    {
+        wrx.write(1);
+        wrx.flush();
+        auto t = bus.transaction( cs );
+        t.write( (d >> 8) & 0xff );
+        t.write(d & 0xff );
+    }
+    trace_end(start, ILI9163_trace_kind::data16, 0, 1, d);
+}
+
+/// send n data bytes in one transaction, after a command
+void ILI9163_spi_res_wrx_cs::data(const uint8_t bytes[], size_t n){
+    auto position = trace_pixels();
+    if(trace != nullptr){
+        trace->add_bytes(bytes, n);
+    }
+    auto start = trace_start();
+    {
+        wrx.write(1);
+        wrx.flush();
+        auto t = bus.transaction( cs );
+        t.write(n, bytes);
+    }
+    trace_end(start, ILI9163_trace_kind::bytes, n > 0 ? bytes[0] : 0, n, 0, position);
 }
 
 /// set colom and page address then start a write transaction
 void ILI9163_spi_res_wrx_cs::setAddress(uint16_t x1,uint16_t y1,uint16_t x2,uint16_t y2) {
-    command( ILI9163_commands::set_column_address);
-    data16(x1);
-    data16(x2);
-
-    command( ILI9163_commands::set_page_address);
-    data16(y1);
-    data16(y2);
-    // memory write
-    command(ILI9163_commands::write_memory_start);
+    const uint8_t columns[] = {
+        (uint8_t) (x1 >> 8), (uint8_t) (x1 & 0xff), (uint8_t) (x2 >> 8), (uint8_t) (x2 & 0xff) };
+    const uint8_t pages[] = {
+        (uint8_t) (y1 >> 8), (uint8_t) (y1 & 0xff), (uint8_t) (y2 >> 8), (uint8_t) (y2 & 0xff) };
+
+    auto start = trace_start();
+    {
+        // one transaction, wrx switches between command and data within it
+        wrx.write(0);
+        wrx.flush();
+        auto t = bus.transaction( cs );
+        t.write( static_cast< uint8_t >( ILI9163_commands::set_column_address ) );
+        wrx.write(1);
+        wrx.flush();
+        t.write(sizeof(columns), columns);
+
+        wrx.write(0);
+        wrx.flush();
+        t.write( static_cast< uint8_t >( ILI9163_commands::set_page_address ) );
+        wrx.write(1);
+        wrx.flush();
+        t.write(sizeof(pages), pages);
+
+        // memory write
+        wrx.write(0);
+        wrx.flush();
+        t.write( static_cast< uint8_t >( ILI9163_commands::write_memory_start ) );
+
+        // the controller cursor is now at x1, y1 but
+        // the window no longer matches the one pixels_byte_write uses
+        cursor = hwlib::xy(255, 255);
+    }
+    trace_end(start, ILI9163_trace_kind::window, 0, (x1 & 0xff) << 8 | (x2 & 0xff), (y1 & 0xff) << 8 | (y2 & 0xff));
+}
+
+/// send n pixels in one transaction, after setAddress
+void ILI9163_spi_res_wrx_cs::pixels(const uint16_t data[], size_t n){
+    auto position = trace_pixels();
+    trace_data(data, n);
+    auto start = trace_start();
+    auto count = n;
+    uint16_t first = n > 0 ? data[0] : 0;
+    {
+        uint8_t bytes[64];
+        wrx.write(1);
+        wrx.flush();
+        auto t = bus.transaction( cs );
+        while(n > 0){
+            size_t chunk = n < sizeof(bytes) / 2 ? n : sizeof(bytes) / 2;
+            for(size_t i = 0; i < chunk; i++){
+                bytes[2 * i]     = (data[i] >> 8) & 0xff;
+                bytes[2 * i + 1] = data[i] & 0xff;
+            }
+            t.write(2 * chunk, bytes);
+            data += chunk;
+            n -= chunk;
+        }
+    }
+    trace_end(start, ILI9163_trace_kind::pixels, 0, count, first, position);
+}
+
+/// send the same pixel n times in one transaction, after setAddress
+void ILI9163_spi_res_wrx_cs::fill(uint16_t colour, size_t n){
+    auto start = trace_start();
+    auto count = n;
+    if(fill_bus != nullptr){
+        fill_bus->write_repeated16(cs, wrx, colour, n);
+    } else{
+        uint8_t bytes[64];
+        for(size_t i = 0; i < sizeof(bytes); i += 2){
+            bytes[i]     = (colour >> 8) & 0xff;
+            bytes[i + 1] = colour & 0xff;
+        }
+        wrx.write(1);
+        wrx.flush();
+        auto t = bus.transaction( cs );
+        while(n > 0){
+            size_t chunk = n < sizeof(bytes) / 2 ? n : sizeof(bytes) / 2;
+            t.write(2 * chunk, bytes);
+            n -= chunk;
+        }
+    }
+    trace_end(start, ILI9163_trace_kind::fill, 0, count, colour);
+}
+
+/// write a size.x x size.y block of pixels at pos as one window and one transaction (not clipped)
+void ILI9163_spi_res_wrx_cs::write_rect(hwlib::xy pos, hwlib::xy size, const uint16_t * src, int stride){
+    if(size.x <= 0 || size.y <= 0){
+        return;
+    }
+    setAddress(pos.x, pos.y, pos.x + size.x - 1, pos.y + size.y - 1);
+    if(stride == size.x){
+        pixels(src, (size_t) size.x * size.y);
+        return;
+    }
+
+    auto position = trace_pixels();
+    if(trace != nullptr){
+        for(int y = 0; y < size.y; y++){
+            trace_data(src + stride * y, size.x);
+        }
+    }
+    auto start = trace_start();
+    uint16_t first = src[0];
+    {
+        uint8_t bytes[64];
+        wrx.write(1);
+        wrx.flush();
+        auto t = bus.transaction( cs );
+        for(int y = 0; y < size.y; y++, src += stride){
+            for(int x = 0; x < size.x; ){
+                int chunk = size.x - x < (int) sizeof(bytes) / 2 ? size.x - x : (int) sizeof(bytes) / 2;
+                for(int i = 0; i < chunk; i++){
+                    bytes[2 * i]     = (src[x + i] >> 8) & 0xff;
+                    bytes[2 * i + 1] = src[x + i] & 0xff;
+                }
+                t.write(2 * chunk, bytes);
+                x += chunk;
+            }
+        }
+    }
+    trace_end(start, ILI9163_trace_kind::pixels, 0, (size_t) size.x * size.y, first, position);
+}
+
+/// \brief
+/// read a size.x x size.y block of pixels at pos from the display (not clipped)
+/// \details
+/// The controller sends each pixel as 3 bytes (18 bit, 6 bits per colour,
+/// left aligned) after one dummy byte, these are converted back to 16 bit.
+/// This needs a bus with a working MISO line.
+void ILI9163_spi_res_wrx_cs::read_rect(hwlib::xy pos, hwlib::xy size, uint16_t * dst, int stride){
+    if(size.x <= 0 || size.y <= 0){
+        return;
+    }
+    const uint8_t columns[] = {
+        0, (uint8_t) pos.x, 0, (uint8_t) (pos.x + size.x - 1) };
+    const uint8_t pages[] = {
+        0, (uint8_t) pos.y, 0, (uint8_t) (pos.y + size.y - 1) };
+    const uint8_t zeros[48] = {};
+    uint8_t bytes[48];
+
+    auto start = trace_start();
+    {
+        wrx.write(0);
+        wrx.flush();
+        auto t = bus.transaction( cs );
+        t.write( static_cast< uint8_t >( ILI9163_commands::set_column_address ) );
+        wrx.write(1);
+        wrx.flush();
+        t.write(sizeof(columns), columns);
+        wrx.write(0);
+        wrx.flush();
+        t.write( static_cast< uint8_t >( ILI9163_commands::set_page_address ) );
+        wrx.write(1);
+        wrx.flush();
+        t.write(sizeof(pages), pages);
+        wrx.write(0);
+        wrx.flush();
+        t.write( static_cast< uint8_t >( ILI9163_commands::read_memory_start ) );
+        wrx.write(1);
+        wrx.flush();
+
+        // dummy byte
+        t.write_and_read(1, zeros, bytes);
+
+        for(int y = 0; y < size.y; y++, dst += stride){
+            for(int x = 0; x < size.x; ){
+                int chunk = size.x - x < 16 ? size.x - x : 16;
+                t.write_and_read(3 * chunk, zeros, bytes);
+                for(int i = 0; i < chunk; i++){
+                    dst[x + i] = ((bytes[3 * i] & 0xf8) << 8)
+                               | ((bytes[3 * i + 1] & 0xfc) << 3)
+                               | (bytes[3 * i + 2] >> 3);
+                }
+                x += chunk;
+            }
+        }
+    }
+    trace_end(start, ILI9163_trace_kind::read, 0, (size_t) size.x * size.y, 0);
+
+    cursor = hwlib::xy(255, 255);
 }
 
 /// write the pixel byte d at column x page y with the color col
@@ -109,9 +341,7 @@ void ILI9163_spi_res_wrx_cs::drawRectFilled(uint16_t x,uint16_t y,uint16_t w,uin
     if ((x + w - 1) >= 128) w = 128 - x;
     if ((y + h - 1) >= 128) h = 128 - y;
     setAddress(x, y, x + w - 1, y + h - 1);
-    for (y = h; y >= 0; y--)
-        for (x = w; x >= 0; x--)
-            data16(colour);
+    fill(colour, (size_t) w * h);
 }
 
 /// draw a biger pixel
@@ -124,49 +354,80 @@ void ILI9163_spi_res_wrx_cs::drawPixel(hwlib::xy location, uint8_t size, uint16_
 
 /// clears the display with color col
 void ILI9163_spi_res_wrx_cs::ILI9163_clear(uint16_t col) {
-
-    for (int i = 0; i <= 128; i++) {
-        for (int j = 0; j <= 129; j++) {
-            pixels_byte_write(hwlib::xy(j, i), col);
-        }
-    }
+    setAddress(0, 0, 129, 128);
+    fill(col, 130 * 129);
 }
 
-//========================================================================================================
-
+/// only refresh rows first_row .. last_row, the rest of the panel shows the background
+void ILI9163_spi_res_wrx_cs::partial_mode(uint16_t first_row, uint16_t last_row){
+    command(ILI9163_commands::set_partial_area);
+    data16(first_row);
+    data16(last_row);
+    command(ILI9163_commands::enter_partial_mode);
+}
 
-void ILI9163_spi_128x128_direct_res_wrx_cs::write_implementation(hwlib::xy pos, hwlib::color col){
+/// refresh the whole panel again
+void ILI9163_spi_res_wrx_cs::normal_mode(){
+    command(ILI9163_commands::enter_normal_mode);
+}
 
-    uint16_t d =
-            ( ( static_cast< uint_fast16_t >(col.blue)   & 0x00f8 ) << 8)
-            + ( ( static_cast< uint_fast16_t >(col.green) & 0x00fc ) << 3 )
-            + ( ( static_cast< uint_fast16_t >(col.red)  & 0x00f8 ) >> 3 );
-    pixels_byte_write(pos, d);
+/// idle mode shows 8 colours (the top bit of each colour) at lower power
+void ILI9163_spi_res_wrx_cs::idle_mode(bool on){
+    command(on ? ILI9163_commands::enter_idle_mode : ILI9163_commands::exit_idle_mode);
+}
 
+/// in sleep mode the panel is off, the GRAM keeps its contents
+void ILI9163_spi_res_wrx_cs::sleep_mode(bool on){
+    if(on){
+        command(ILI9163_commands::enter_sleep_mode);
+        hwlib::wait_ms(5);
+    } else{
+        command(ILI9163_commands::exit_sleep_mode);
+        hwlib::wait_ms(120);
+    }
 }
 
-void ILI9163_spi_128x128_direct_res_wrx_cs::clear_implementation( hwlib::color col ){
+/// \brief
+/// set the normal mode frame rate closest to hz, returns the rate that was set
+/// \details
+/// The rate is fosc / (DIVA * (128 + VPA)), with fosc chosen so that
+/// the power on setting DIVA = 8, VPA = 8 gives 62 Hz.
+/// This is an estimate, the oscillator differs per panel.
+uint_fast16_t ILI9163_spi_res_wrx_cs::frame_rate(uint_fast16_t hz){
+    const uint_fast32_t fosc = 67'456;
+    if(hz == 0){
+        hz = 1;
+    }
 
-    // convert hwlib color into uint16
-    uint16_t d =
-            ( ( static_cast< uint_fast16_t >(col.blue)   & 0x00f8 ) << 8)
-            + ( ( static_cast< uint_fast16_t >(col.green) & 0x00fc ) << 3 )
-            + ( ( static_cast< uint_fast16_t >(col.red)  & 0x00f8 ) >> 3 );
+    uint_fast32_t best_diva = 8, best_vpa = 8, best = fosc / (8 * (128 + 8));
+    for(uint_fast32_t diva = 1; diva <= 31; diva++){
+        // the closest VPA for this DIVA is one of the two line counts
+        // around hz: the last that is not slower and the first that is
+        uint_fast32_t lines = fosc / (diva * hz);
+        for(uint_fast32_t n = lines; n <= lines + 1; n++){
+            uint_fast32_t vpa = n < 128 ? 0 : n - 128;
+            if(vpa > 63){
+                vpa = 63;
+            }
+            uint_fast32_t rate = fosc / (diva * (128 + vpa));
+            uint_fast32_t error = rate > hz ? rate - hz : hz - rate;
+            uint_fast32_t best_error = best > hz ? best - hz : hz - best;
+            if(error < best_error){
+                best_diva = diva;
+                best_vpa = vpa;
+                best = rate;
+            }
+        }
+    }
 
-    ILI9163_clear(d);
+    command(ILI9163_commands::FRAME_RATE_CONTROL1);
+    parameter(best_diva);
+    parameter(best_vpa);
+    return best;
 }
 
-/// ILI9163_spi_128x128_direct_res_wrx_cs constructor
-///
-/// construct by providing the spi channel and initialize the display
-ILI9163_spi_128x128_direct_res_wrx_cs::ILI9163_spi_128x128_direct_res_wrx_cs(hwlib::spi_bus & bus,
-                                                                             hwlib::target::pin_out & res,
-                                                                             hwlib::target::pin_out & wrx,
-                                                                             hwlib::target::pin_out & cs):
-
-    ILI9163_spi_res_wrx_cs(bus, res, wrx, cs),
-    window( wsize, hwlib::black, hwlib::white )
-{
+/// initialize the display: exit sleep, 16 bit pixels, gamma, power and frame rate, display on
+void ILI9163_spi_res_wrx_cs::initialise(){
     // exit sleep mode
     command(ILI9163_commands::exit_sleep_mode);
     hwlib::wait_ms(5);
@@ -234,121 +495,208 @@ ILI9163_spi_128x128_direct_res_wrx_cs::ILI9163_spi_128x128_direct_res_wrx_cs(hwl
     // Set the display to on
     command(ILI9163_commands::set_display_on);
     command(ILI9163_commands::write_memory_start);
-
 }
 
 //========================================================================================================
 
-void ILI9163_spi_128x128_buffered_res_wrx_cs::write_implementation(hwlib::xy pos, hwlib::color col){
 
-    int a = pos.x + wsize.x * pos.y;
+void ILI9163_spi_128x128_direct_res_wrx_cs::write_implementation(hwlib::xy pos, hwlib::color col){
 
-    buffer[a] =
-    ( ( static_cast< uint_fast16_t >(col.blue)   & 0x00f8 ) << 8)
-    + ( ( static_cast< uint_fast16_t >(col.green) & 0x00fc ) << 3 )
-    + ( ( static_cast< uint_fast16_t >(col.red)  & 0x00f8 ) >> 3 );
-}
+    pixels_byte_write(pos, rgb565_from_color(col));
 
-void ILI9163_spi_128x128_buffered_res_wrx_cs::clear_implementation( hwlib::color col ){
+}
 
-    uint16_t d =
-            ( ( static_cast< uint_fast16_t >(col.blue)   & 0x00f8 ) << 8)
-            + ( ( static_cast< uint_fast16_t >(col.green) & 0x00fc ) << 3 )
-            + ( ( static_cast< uint_fast16_t >(col.red)  & 0x00f8 ) >> 3 );
+void ILI9163_spi_128x128_direct_res_wrx_cs::clear_implementation( hwlib::color col ){
 
-    for (int i = 0; i <= 128; i++) {
-        for (int j = 0; j <= 129; j++) {
-            int a = j + wsize.x * i;
-            buffer[a] = d;
-        }
-    }
+    ILI9163_clear(rgb565_from_color(col));
 }
 
-/// ILI9163_spi_128x128_buffered_res_wrx_cs constructor
+/// ILI9163_spi_128x128_direct_res_wrx_cs constructor
 ///
 /// construct by providing the spi channel and initialize the display
-ILI9163_spi_128x128_buffered_res_wrx_cs::ILI9163_spi_128x128_buffered_res_wrx_cs(hwlib::spi_bus & bus, hwlib::target::pin_out & res,
-                                        hwlib::target::pin_out & wrx, hwlib::target::pin_out & cs):
+ILI9163_spi_128x128_direct_res_wrx_cs::ILI9163_spi_128x128_direct_res_wrx_cs(hwlib::spi_bus & bus,
+                                                                             ILI9163_pin_out & res,
+                                                                             ILI9163_pin_out & wrx,
+                                                                             ILI9163_pin_out & cs):
 
     ILI9163_spi_res_wrx_cs(bus, res, wrx, cs),
     window( wsize, hwlib::black, hwlib::white )
 {
-    command(ILI9163_commands::exit_sleep_mode);
-    hwlib::wait_ms(5);
+    initialise();
+}
 
-    command(ILI9163_commands::set_pixel_format);
-    parameter(0x05);
+/// ILI9163_spi_128x128_direct_res_wrx_cs constructor
+///
+/// construct with a bus that sends the fills itself, eg ILI9163_spi_bus_bit_banged_sclk_mosi
+ILI9163_spi_128x128_direct_res_wrx_cs::ILI9163_spi_128x128_direct_res_wrx_cs(ILI9163_fill_spi_bus & bus,
+                                                                             ILI9163_pin_out & res,
+                                                                             ILI9163_pin_out & wrx,
+                                                                             ILI9163_pin_out & cs):
 
-    command(ILI9163_commands::set_gamma_curve);
-    parameter(0x04);
+    ILI9163_spi_res_wrx_cs(bus, res, wrx, cs),
+    window( wsize, hwlib::black, hwlib::white )
+{
+    initialise();
+}
 
-    command(ILI9163_commands::GAM_R_SEL);
-    parameter(0x01);
+/// fill a block of the display in one window
+void ILI9163_spi_128x128_direct_res_wrx_cs::fill_rect(hwlib::xy pos, hwlib::xy size, uint16_t colour){
+    if(size.x <= 0 || size.y <= 0){
+        return;
+    }
+    setAddress(pos.x, pos.y, pos.x + size.x - 1, pos.y + size.y - 1);
+    fill(colour, (size_t) size.x * size.y);
+}
 
-    command(ILI9163_commands::POSITIVE_GAMMA_CORRECT);
-    parameter(0x3f); parameter(0x25); parameter(0x1c);
-    parameter(0x1e); parameter(0x20); parameter(0x12);
-    parameter(0x2a); parameter(0x90); parameter(0x24);
-    parameter(0x11); parameter(0x00); parameter(0x00);
-    parameter(0x00); parameter(0x00); parameter(0x00);
+//========================================================================================================
 
-    command(ILI9163_commands::NEGATIVE_GAMMA_CORRECT);
-    parameter(0x20); parameter(0x20); parameter(0x20);
-    parameter(0x20); parameter(0x05); parameter(0x00);
-    parameter(0x15); parameter(0xa7); parameter(0x3d);
-    parameter(0x18); parameter(0x25); parameter(0x2a);
-    parameter(0x2b); parameter(0x2b); parameter(0x3a);
+void ILI9163_spi_128x128_buffered_res_wrx_cs::write_implementation(hwlib::xy pos, hwlib::color col){
 
-    command(ILI9163_commands::FRAME_RATE_CONTROL1);
-    parameter(0x08); parameter(0x08); // DIVA = 8 // VPA = 8
+    int a = pos.x + wsize.x * pos.y;
 
-    command(ILI9163_commands::DISPLAY_INVERSION);
-    parameter(0x07); // NLA = 1, NLB = 1, NLC = 1 (all on Frame Inversion)
+    buffer[a] = rgb565_from_color(col);
+}
 
-    command(ILI9163_commands::POWER_CONTROL1);
-    parameter(0x0a); // VRH = 10:  GVDD = 4.30
-    parameter(0x02); // VC = 2: VCI1 = 2.65
+void ILI9163_spi_128x128_buffered_res_wrx_cs::clear_implementation( hwlib::color col ){
 
-    command(ILI9163_commands::POWER_CONTROL2);
-    parameter(0x02); // BT = 2: AVDD = 2xVCI1, VCL = -1xVCI1, VGH = 5xVCI1, VGL = -2xVCI1
+    rgb565_fill(buffer, buffsize, rgb565_from_color(col));
+}
 
-    command(ILI9163_commands::VCOM_CONTROL1);
-    parameter(0x50); // VMH = 80: VCOMH voltage = 4.5
-    parameter(0x5b); // VML = 91: VCOML voltage = -0.225
+/// ILI9163_spi_128x128_buffered_res_wrx_cs constructor
+///
+/// construct by providing the spi channel and initialize the display
+ILI9163_spi_128x128_buffered_res_wrx_cs::ILI9163_spi_128x128_buffered_res_wrx_cs(hwlib::spi_bus & bus, ILI9163_pin_out & res,
+                                        ILI9163_pin_out & wrx, ILI9163_pin_out & cs):
 
-    command(ILI9163_commands::VCOM_OFFSET_CONTROL);
-    parameter(0x40); // nVM = 0, VMF = 64: VCOMH output = VMH, VCOML output = VML
+    ILI9163_spi_res_wrx_cs(bus, res, wrx, cs),
+    window( wsize, hwlib::black, hwlib::white ),
+    flush_row( 0 ),
+    row_us( 0 ),
+    hashes_valid( false )
+{
+    initialise();
+}
 
-    command(ILI9163_commands::set_column_address);
-    parameter(0x00); // XSH
-    parameter(0x00); // XSL
-    parameter(0x00); // XEH
-    parameter(0x7f); // XEL (128 pixels x)
+/// write the buffer to the display
+void ILI9163_spi_128x128_buffered_res_wrx_cs::flush(){
+    flush_row = 0;
+    flush_step(wsize.y);
+}
 
-    command(ILI9163_commands::set_page_address);
-    parameter(0x00);
-    parameter(0x00);
-    parameter(0x00);
-    parameter(0x7f); // 128 pixels y
+/// hash of the pixels of tile (tx, ty)
+uint32_t ILI9163_spi_128x128_buffered_res_wrx_cs::hash_tile(int tx, int ty) const {
+    int x0 = tx * tile;
+    int y0 = ty * tile;
+    int w = wsize.x - x0 < tile ? wsize.x - x0 : tile;
+    int h = wsize.y - y0 < tile ? wsize.y - y0 : tile;
+
+    // FNV-1a over the 16 bit pixels
+    uint32_t hash = 2166136261u;
+    const uint16_t * row = buffer + x0 + wsize.x * y0;
+    for(int y = 0; y < h; y++, row += wsize.x){
+        for(int x = 0; x < w; x++){
+            hash = (hash ^ row[x]) * 16777619u;
+        }
+    }
+    return hash;
+}
 
-    // Select display orientation
-    command(ILI9163_commands::set_address_mode);
-    parameter(0x00);
+/// send the changed tiles of band ty, adjacent changed tiles as one window
+void ILI9163_spi_128x128_buffered_res_wrx_cs::flush_band(int ty){
+    int y0 = ty * tile;
+    int h = wsize.y - y0 < tile ? wsize.y - y0 : tile;
+    uint32_t * hash = tile_hash + ty * tiles.x;
+
+    int first = -1;
+    for(int tx = 0; tx <= tiles.x; tx++){
+        bool changed = false;
+        if(tx < tiles.x){
+            uint32_t now = hash_tile(tx, ty);
+            changed = !hashes_valid || now != hash[tx];
+            hash[tx] = now;
+        }
+        if(changed && first < 0){
+            first = tx;
+        }
+        if(!changed && first >= 0){
+            int x0 = first * tile;
+            int x1 = tx * tile < wsize.x ? tx * tile : wsize.x;
+            ILI9163_spi_res_wrx_cs::write_rect(hwlib::xy(x0, y0), hwlib::xy(x1 - x0, h),
+                                               buffer + x0 + wsize.x * y0, wsize.x);
+            first = -1;
+        }
+    }
+}
 
-    // Set the display to on
-    command(ILI9163_commands::set_display_on);
-    command(ILI9163_commands::write_memory_start);
+/// write the next max_rows rows of the buffer to the display
+bool ILI9163_spi_128x128_buffered_res_wrx_cs::flush_step(uint_fast16_t max_rows){
+    // whole bands that fit in max_rows, but at least one
+    uint_fast16_t rows = 0;
+    do {
+        uint_fast16_t h = wsize.y - flush_row < tile ? wsize.y - flush_row : tile;
+        flush_band(flush_row / tile);
+        flush_row += h;
+        rows += h;
+    } while(flush_row < (uint_fast16_t) wsize.y
+        && rows + (wsize.y - flush_row < tile ? wsize.y - flush_row : tile) <= max_rows);
+
+    if(flush_row < (uint_fast16_t) wsize.y){
+        return false;
+    }
+    flush_row = 0;
+    hashes_valid = true;
+    return true;
+}
 
+/// forget the tile hashes, so the next flush sends everything
+void ILI9163_spi_128x128_buffered_res_wrx_cs::invalidate(){
+    hashes_valid = false;
+    flush_row = 0;
 }
 
-/// write the buffer to the display
-void ILI9163_spi_128x128_buffered_res_wrx_cs::flush(){
+/// copy a block of pixels into the buffer
+void ILI9163_spi_128x128_buffered_res_wrx_cs::write_rect(hwlib::xy pos, hwlib::xy size, const uint16_t * src, int stride){
+    rgb565_copy_rect(buffer + pos.x + wsize.x * pos.y, wsize.x, src, stride, size.x, size.y);
+}
+
+/// fill a block of the buffer
+void ILI9163_spi_128x128_buffered_res_wrx_cs::fill_rect(hwlib::xy pos, hwlib::xy size, uint16_t colour){
+    rgb565_fill_rect(buffer + pos.x + wsize.x * pos.y, wsize.x, size.x, size.y, colour);
+}
 
-    setAddress(0, 0, 0x81, 0x80);
-    for (int i = 0; i <= 128; i++) {
-        for (int j = 0; j <= 129; j++) {
-            int a = j + wsize.x * i;
-            data16(buffer[a]);
+/// write the buffer to the display for at most us microseconds
+bool ILI9163_spi_128x128_buffered_res_wrx_cs::flush_for(uint_fast32_t us){
+    auto start = hwlib::now_us();
+    bool first = true;
+    for(;;){
+        auto elapsed = hwlib::now_us() - start;
+        uint_fast32_t rows = 1;
+        if(row_us > 0){
+            rows = elapsed < us ? (us - elapsed) / row_us : 0;
+        }
+        // after the first band, stop when the next band no longer fits
+        uint_fast32_t band = wsize.y - flush_row < tile ? wsize.y - flush_row : tile;
+        if(rows < band){
+            if(!first){
+                return false;
+            }
+            rows = band;
+        }
+        first = false;
+        if(rows > (uint_fast32_t) wsize.y){
+            rows = wsize.y;
+        }
+
+        auto t = hwlib::now_us();
+        uint_fast16_t before = flush_row;
+        bool done = flush_step(rows);
+        uint_fast16_t sent = (done ? wsize.y : flush_row) - before;
+        row_us = (hwlib::now_us() - t) / sent;
+        if(row_us == 0){
+            row_us = 1;
+        }
+        if(done){
+            return true;
         }
     }
 }
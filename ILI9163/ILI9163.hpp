@@ -15,6 +15,8 @@
 #define ILI9163_HPP
 
 #include "hwlib.hpp"
+#include "ILI9163_commands.hpp"
+#include "ILI9163_trace.hpp"
 
 ///@file
 
@@ -34,70 +36,6 @@
 /// This type of display is reasonably priced
 /// and available from lots of sources.
 
-/// ILI9163 chip commands
-enum class ILI9163_commands : uint8_t {
-    nop                                   = 0x00,
-    soft_reset                            = 0x01,
-    get_red_channel                       = 0x06,
-    get_green_channel                     = 0x07,
-    get_blue_channel                      = 0x08,
-    get_pixel_format                      = 0x0c,
-    get_power_mode                        = 0x0a,
-    get_address_mode                      = 0x0b,
-    get_display_mode                      = 0x0d,
-    get_signal_mode                       = 0x0e,
-    get_diagnostic_result                 = 0x0f,
-    enter_sleep_mode                      = 0x10,
-    exit_sleep_mode                       = 0x11,
-    enter_partial_mode                    = 0x12,
-    enter_normal_mode                     = 0x13,
-    exit_invert_mode                      = 0x20,
-    enter_invert_mode                     = 0x21,
-    set_gamma_curve                       = 0x26,
-    set_display_off                       = 0x28,
-    set_display_on                        = 0x29,
-    set_column_address                    = 0x2a,
-    set_page_address                      = 0x2b,
-    write_memory_start                    = 0x2c,
-    write_LUT                             = 0x2d,
-    read_memory_start                     = 0x2e,
-    set_partial_area                      = 0x30,
-    set_scroll_area                       = 0x33,
-    set_tear_off                          = 0x34,
-    set_tear_on                           = 0x35,
-    set_address_mode                      = 0x36,
-    set_scroll_start                      = 0x37,
-    exit_idle_mode                        = 0x38,
-    enter_idle_mode                       = 0x39,
-    set_pixel_format                      = 0x3a,
-    write_memory_continue                 = 0x3c,
-    read_memory_continue                  = 0x3e,
-    set_tear_scanline                     = 0x44,
-    get_scanline                          = 0x45,
-    Read_ID1                              = 0xda,
-    Read_ID2                              = 0xdb,
-    Read_ID3                              = 0xdc,
-    GAM_R_SEL                             = 0xf2,
-    NEGATIVE_GAMMA_CORRECT                = 0xE1,
-    POSITIVE_GAMMA_CORRECT                = 0xE0,
-    POWER_CONTROL1                        = 0xC0,
-    POWER_CONTROL2                        = 0xC1,
-    POWER_CONTROL3                        = 0xC2,
-    POWER_CONTROL4                        = 0xC3,
-    POWER_CONTROL5                        = 0xC4,
-    VCOM_CONTROL1                         = 0xC5,
-    VCOM_CONTROL2                         = 0xC6,
-    VCOM_OFFSET_CONTROL                   = 0xC7,
-    FRAME_RATE_CONTROL1                   = 0xB1,
-    FRAME_RATE_CONTROL2                   = 0xB2,
-    FRAME_RATE_CONTROL3                   = 0xB3,
-    DISPLAY_INVERSION                     = 0xB4,
-    SOURCE_DRIVER_DIRECTION               = 0xB7,
-    GATE_DRIVER_DIRECTION                 = 0xB8,
-    WRITE_ID4_VALUE                       = 0xD3,
-    NV_MEMORY_FUNCTION1                   = 0xD7,
-    NV_MEMORY_FUNCTION2                   = 0xDE
-};
 
 // ==========================================================================
 //
@@ -105,32 +43,105 @@ enum class ILI9163_commands : uint8_t {
 //
 // ==========================================================================
 
+/// \brief
+/// type of the res, wrx and cs pins
+/// \details
+/// On the target the concrete pin class, so the pin writes are not virtual.
+/// On the host any hwlib pin, so a simulated bus can follow wrx.
+#ifdef BMPTK_TARGET_native
+using ILI9163_pin_out = hwlib::pin_out;
+#else
+using ILI9163_pin_out = hwlib::target::pin_out;
+#endif
+
+/// \brief
+/// spi bus that can send one 16 bit value many times
+/// \details
+/// A display constructed with such a bus sends its fills (clear, filled
+/// rectangles, runs) with write_repeated16 instead of through a buffer.
+class ILI9163_fill_spi_bus : public hwlib::spi_bus {
+public:
+    /// set dc (data) and send value n times in one transaction on sel
+    virtual void write_repeated16(hwlib::pin_out & sel, hwlib::pin_out & dc, uint16_t value, size_t n) = 0;
+};
+
 /// abstract ILI9163 class
 class ILI9163_spi_res_wrx_cs {
 protected:
 
     // the spi bus & pins
     hwlib::spi_bus & bus;
-    hwlib::target::pin_out & res;
-    hwlib::target::pin_out & wrx;
-    hwlib::target::pin_out & cs;
+    ILI9163_pin_out & res;
+    ILI9163_pin_out & wrx;
+    ILI9163_pin_out & cs;
+
+    // the same bus when it can fill by itself, else nullptr
+    ILI9163_fill_spi_bus * fill_bus;
 
     // current cursor location in the controller
     hwlib::xy cursor;
 
+    friend class ILI9163_display_list;
+
+    void initialise();
+
+    // traffic capture, nullptr when not capturing
+    ILI9163_trace * trace;
+
+    uint32_t trace_start() const {
+        return trace != nullptr ? (uint32_t) hwlib::now_ticks() : 0;
+    }
+
+    void trace_end(uint32_t start, ILI9163_trace_kind kind, uint8_t byte, size_t count, uint16_t value, uint32_t data = 0);
+
+    // position of the next pixel in the pixel data of the trace
+    uint32_t trace_pixels() const {
+        return trace != nullptr ? trace->pixel_position() : 0;
+    }
+
+    // add the pixels of a burst to the pixel data of the trace
+    void trace_data(const uint16_t data[], size_t n){
+        if(trace != nullptr){
+            trace->add_pixels(data, n);
+        }
+    }
+
 public:
 
-    ILI9163_spi_res_wrx_cs(hwlib::spi_bus & bus, hwlib::target::pin_out & res, hwlib::target::pin_out & wrx, hwlib::target::pin_out & cs);
+    ILI9163_spi_res_wrx_cs(hwlib::spi_bus & bus, ILI9163_pin_out & res, ILI9163_pin_out & wrx, ILI9163_pin_out & cs);
+    ILI9163_spi_res_wrx_cs(ILI9163_fill_spi_bus & bus, ILI9163_pin_out & res, ILI9163_pin_out & wrx, ILI9163_pin_out & cs);
     void command( ILI9163_commands c );
     void parameter( uint8_t p );
     void data(uint8_t d);
     void data16(uint16_t d);
+    void data(const uint8_t bytes[], size_t n);
     void setAddress(uint16_t x1,uint16_t y1,uint16_t x2,uint16_t y2);
+    void pixels(const uint16_t data[], size_t n);
+    void fill(uint16_t colour, size_t n);
+    void write_rect(hwlib::xy pos, hwlib::xy size, const uint16_t * src, int stride);
+    void read_rect(hwlib::xy pos, hwlib::xy size, uint16_t * dst, int stride);
     void pixels_byte_write(hwlib::xy location, uint16_t col);
     void drawRectFilled(uint16_t x,uint16_t y,uint16_t w,uint16_t h,uint16_t colour);
     void drawPixel(hwlib::xy location, uint8_t size, uint16_t colour);
     void ILI9163_clear(uint16_t col);
 
+    // power and refresh control
+    void partial_mode(uint16_t first_row, uint16_t last_row);
+    void normal_mode();
+    void idle_mode(bool on);
+    void sleep_mode(bool on);
+    uint_fast16_t frame_rate(uint_fast16_t hz);
+
+    /// \brief
+    /// log the traffic to the display into t
+    /// \details
+    /// Every command, parameter, address window and pixel run is added to
+    /// the trace with its start and end time, and the pixels of each run
+    /// to its pixel data when it has storage for that. Pass nullptr to stop.
+    void capture(ILI9163_trace * t){
+        trace = t;
+    }
+
 };
 
 // ==========================================================================
@@ -152,11 +163,16 @@ private:
 
 public:
 
-    ILI9163_spi_128x128_direct_res_wrx_cs(hwlib::spi_bus & bus, hwlib::target::pin_out & res,
-                                          hwlib::target::pin_out & wrx, hwlib::target::pin_out & cs);
+    ILI9163_spi_128x128_direct_res_wrx_cs(hwlib::spi_bus & bus, ILI9163_pin_out & res,
+                                          ILI9163_pin_out & wrx, ILI9163_pin_out & cs);
+    ILI9163_spi_128x128_direct_res_wrx_cs(ILI9163_fill_spi_bus & bus, ILI9163_pin_out & res,
+                                          ILI9163_pin_out & wrx, ILI9163_pin_out & cs);
 
     /// flush does nothing
     void flush() override {}
+
+    /// fill a size.x x size.y block at pos with colour (not clipped)
+    void fill_rect(hwlib::xy pos, hwlib::xy size, uint16_t colour);
 };
 
 
@@ -172,11 +188,64 @@ private:
     void write_implementation(hwlib::xy pos, hwlib::color col) override;
     void clear_implementation( hwlib::color col ) override;
 
+    // incremental flush: next row to send and the measured time per row
+    uint_fast16_t flush_row;
+    uint_fast32_t row_us;
+
+    // hash of each 8x8 tile as last sent, only tiles that changed are sent
+    static constexpr int tile = 8;
+    static auto constexpr tiles = hwlib::xy((wsize.x + tile - 1) / tile, (wsize.y + tile - 1) / tile);
+    uint32_t tile_hash[tiles.x * tiles.y];
+    bool hashes_valid;
+
+    uint32_t hash_tile(int tx, int ty) const;
+    void flush_band(int ty);
+
 public:
 
-    ILI9163_spi_128x128_buffered_res_wrx_cs(hwlib::spi_bus & bus, hwlib::target::pin_out & res,
-                                            hwlib::target::pin_out & wrx,hwlib::target::pin_out & cs);
+    ILI9163_spi_128x128_buffered_res_wrx_cs(hwlib::spi_bus & bus, ILI9163_pin_out & res,
+                                            ILI9163_pin_out & wrx,ILI9163_pin_out & cs);
+
+    /// \brief
+    /// write the changed parts of the buffer to the display
+    /// \details
+    /// The buffer is divided in 8x8 tiles. A tile is only sent when its
+    /// hash differs from the hash of the tile as it was last sent, and
+    /// adjacent changed tiles in a band of 8 rows are sent as one window.
+    /// So redrawing the whole buffer every frame only sends what changed.
     void flush() override;
+
+    /// \brief
+    /// send at most max_rows rows of the buffer
+    /// \details
+    /// Continues where the previous call stopped. The rows are sent in
+    /// bands of 8 (the tile height): as many whole bands as fit in max_rows,
+    /// but at least one, so a budget below 8 rows still sends a band.
+    /// Returns true when the last row of the frame has been sent,
+    /// the next call then starts a new frame.
+    bool flush_step(uint_fast16_t max_rows);
+
+    /// the first row the next flush_step() sends
+    uint_fast16_t next_row() const {
+        return flush_row;
+    }
+
+    /// send every tile on the next flush, for instance when the display was written directly
+    void invalidate();
+
+    /// \brief
+    /// send as many rows as fit in us microseconds
+    /// \details
+    /// Sends at least one band, the number of rows is estimated from
+    /// the time the previous rows took.
+    /// Returns true when the last row of the frame has been sent.
+    bool flush_for(uint_fast32_t us);
+
+    /// copy a size.x x size.y block of pixels into the buffer at pos (not clipped)
+    void write_rect(hwlib::xy pos, hwlib::xy size, const uint16_t * src, int stride);
+
+    /// fill a size.x x size.y block of the buffer at pos with colour (not clipped)
+    void fill_rect(hwlib::xy pos, hwlib::xy size, uint16_t colour);
 };
 
 using ILI9163_display = ILI9163_spi_128x128_direct_res_wrx_cs;
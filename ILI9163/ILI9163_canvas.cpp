@@ -0,0 +1,112 @@
+// ==========================================================================
+//
+// Author    : Mohammad Hawari
+// File      : ILI9163_canvas.cpp
+// Part of   : ILI9163 library for controlling a ILI9163 LCD display
+// Copyright : Mohammad Hawari 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// ==========================================================================
+
+#include "ILI9163_canvas.hpp"
+#include "ILI9163_rgb565.hpp"
+
+///@file
+
+// display size
+static auto constexpr wsize = hwlib::xy(130, 129);
+
+// the part of a size block at pos that falls inside target:
+// returns false when nothing is visible, otherwise moves pos, size
+// and offset (the first visible pixel of the block) to the visible part
+static bool clip(hwlib::xy & pos, hwlib::xy & size, hwlib::xy & offset, hwlib::xy target){
+    offset = hwlib::xy(0, 0);
+    if(pos.x < 0){
+        offset.x = -pos.x;
+        size.x += pos.x;
+        pos.x = 0;
+    }
+    if(pos.y < 0){
+        offset.y = -pos.y;
+        size.y += pos.y;
+        pos.y = 0;
+    }
+    if(pos.x + size.x > target.x){
+        size.x = target.x - pos.x;
+    }
+    if(pos.y + size.y > target.y){
+        size.y = target.y - pos.y;
+    }
+    return size.x > 0 && size.y > 0;
+}
+
+//========================================================================================================
+
+/// ILI9163_canvas constructor
+///
+/// construct by providing the size and storage for size.x * size.y pixels
+ILI9163_canvas::ILI9163_canvas(hwlib::xy size, uint16_t * storage):
+    window( size, hwlib::black, hwlib::white ),
+    storage( storage )
+{}
+
+void ILI9163_canvas::write_implementation(hwlib::xy pos, hwlib::color col){
+    storage[pos.x + size.x * pos.y] = rgb565_from_color(col);
+}
+
+void ILI9163_canvas::clear_implementation(hwlib::color col){
+    rgb565_fill(storage, (size_t) size.x * size.y, rgb565_from_color(col));
+}
+
+void ILI9163_canvas::draw(ILI9163_spi_res_wrx_cs & display, hwlib::xy pos) const {
+    hwlib::xy part = size;
+    hwlib::xy offset;
+    if(clip(pos, part, offset, wsize)){
+        display.write_rect(pos, part, storage + offset.x + size.x * offset.y, size.x);
+    }
+}
+
+void ILI9163_canvas::draw(ILI9163_spi_128x128_buffered_res_wrx_cs & display, hwlib::xy pos) const {
+    hwlib::xy part = size;
+    hwlib::xy offset;
+    if(clip(pos, part, offset, wsize)){
+        display.write_rect(pos, part, storage + offset.x + size.x * offset.y, size.x);
+    }
+}
+
+void ILI9163_canvas::draw(ILI9163_canvas & parent, hwlib::xy pos) const {
+    hwlib::xy part = size;
+    hwlib::xy offset;
+    if(clip(pos, part, offset, parent.size)){
+        rgb565_copy_rect(parent.storage + pos.x + parent.size.x * pos.y, parent.size.x,
+                         storage + offset.x + size.x * offset.y, size.x, part.x, part.y);
+    }
+}
+
+void ILI9163_canvas::read(ILI9163_spi_res_wrx_cs & display, hwlib::xy pos){
+    hwlib::xy part = size;
+    hwlib::xy offset;
+    if(clip(pos, part, offset, wsize)){
+        display.read_rect(pos, part, storage + offset.x + size.x * offset.y, size.x);
+    }
+}
+
+void ILI9163_canvas::blend(ILI9163_spi_res_wrx_cs & display, hwlib::xy pos, uint8_t alpha) const {
+    hwlib::xy part = size;
+    hwlib::xy offset;
+    if(!clip(pos, part, offset, wsize)){
+        return;
+    }
+    uint16_t row[wsize.x];
+    for(int y = 0; y < part.y; y++){
+        hwlib::xy at(pos.x, pos.y + y);
+        display.read_rect(at, hwlib::xy(part.x, 1), row, part.x);
+        rgb565_blend(row, storage + offset.x + size.x * (offset.y + y), part.x, alpha);
+        display.write_rect(at, hwlib::xy(part.x, 1), row, part.x);
+    }
+}
+
+//========================================================================================================
@@ -0,0 +1,90 @@
+// ==========================================================================
+//
+// Author    : Mohammad Hawari
+// File      : ILI9163_canvas.hpp
+// Part of   : ILI9163 library for controlling a ILI9163 LCD display
+// Copyright : Mohammad Hawari 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// ==========================================================================
+
+#ifndef ILI9163_CANVAS_HPP
+#define ILI9163_CANVAS_HPP
+
+#include "hwlib.hpp"
+#include "ILI9163.hpp"
+
+///@file
+
+/// \brief
+/// off-screen canvas
+/// \details
+/// A hwlib::window of any size that draws into caller supplied storage
+/// of size.x * size.y pixels (static, or taken from a pool).
+/// Pre-render a widget once, then draw it onto a display or another
+/// canvas as often as needed. Drawing onto a display sends the visible
+/// part as one address window, drawing onto a buffered display or another
+/// canvas only copies memory.
+class ILI9163_canvas : public hwlib::window {
+private:
+    uint16_t * storage;
+
+    void write_implementation(hwlib::xy pos, hwlib::color col) override;
+    void clear_implementation(hwlib::color col) override;
+
+public:
+    ILI9163_canvas(hwlib::xy size, uint16_t * storage);
+
+    /// the pixels, row by row
+    uint16_t * pixels(){
+        return storage;
+    }
+
+    const uint16_t * pixels() const {
+        return storage;
+    }
+
+    /// draw the canvas with its top left corner at pos directly on the display
+    void draw(ILI9163_spi_res_wrx_cs & display, hwlib::xy pos) const;
+
+    /// draw the canvas with its top left corner at pos into the buffer of the display
+    void draw(ILI9163_spi_128x128_buffered_res_wrx_cs & display, hwlib::xy pos) const;
+
+    /// draw the canvas with its top left corner at pos into another canvas
+    void draw(ILI9163_canvas & parent, hwlib::xy pos) const;
+
+    /// \brief
+    /// read the part of the display below the canvas at pos into the canvas
+    /// \details
+    /// Use it to save what is under a sprite or popup, and draw() to restore it.
+    /// The display bus must be able to read (MISO).
+    void read(ILI9163_spi_res_wrx_cs & display, hwlib::xy pos);
+
+    /// \brief
+    /// blend the canvas with its top left corner at pos onto the display
+    /// \details
+    /// Each row is read back from the display, mixed with the canvas
+    /// (alpha 255 is only the canvas) and written again,
+    /// so no frame buffer is needed. The display bus must be able to read (MISO).
+    void blend(ILI9163_spi_res_wrx_cs & display, hwlib::xy pos, uint8_t alpha) const;
+};
+
+/// storage of ILI9163_static_canvas, a base so it is constructed before the canvas uses it
+template< int W, int H >
+struct ILI9163_canvas_storage {
+    uint16_t pixel_storage[W * H];
+};
+
+/// canvas that holds its own W x H storage
+template< int W, int H >
+class ILI9163_static_canvas : private ILI9163_canvas_storage< W, H >, public ILI9163_canvas {
+public:
+    ILI9163_static_canvas():
+        ILI9163_canvas( hwlib::xy(W, H), this->pixel_storage )
+    {}
+};
+
+#endif //ILI9163_CANVAS_HPP
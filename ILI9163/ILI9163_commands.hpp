@@ -0,0 +1,86 @@
+// ==========================================================================
+//
+// Author    : Mohammad Hawari
+// File      : ILI9163_commands.hpp
+// Part of   : ILI9163 library for controlling a ILI9163 LCD display
+// Copyright : Mohammad Hawari 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// ==========================================================================
+
+#ifndef ILI9163_COMMANDS_HPP
+#define ILI9163_COMMANDS_HPP
+
+#include "hwlib.hpp"
+
+///@file
+
+/// ILI9163 chip commands
+enum class ILI9163_commands : uint8_t {
+    nop                                   = 0x00,
+    soft_reset                            = 0x01,
+    get_red_channel                       = 0x06,
+    get_green_channel                     = 0x07,
+    get_blue_channel                      = 0x08,
+    get_pixel_format                      = 0x0c,
+    get_power_mode                        = 0x0a,
+    get_address_mode                      = 0x0b,
+    get_display_mode                      = 0x0d,
+    get_signal_mode                       = 0x0e,
+    get_diagnostic_result                 = 0x0f,
+    enter_sleep_mode                      = 0x10,
+    exit_sleep_mode                       = 0x11,
+    enter_partial_mode                    = 0x12,
+    enter_normal_mode                     = 0x13,
+    exit_invert_mode                      = 0x20,
+    enter_invert_mode                     = 0x21,
+    set_gamma_curve                       = 0x26,
+    set_display_off                       = 0x28,
+    set_display_on                        = 0x29,
+    set_column_address                    = 0x2a,
+    set_page_address                      = 0x2b,
+    write_memory_start                    = 0x2c,
+    write_LUT                             = 0x2d,
+    read_memory_start                     = 0x2e,
+    set_partial_area                      = 0x30,
+    set_scroll_area                       = 0x33,
+    set_tear_off                          = 0x34,
+    set_tear_on                           = 0x35,
+    set_address_mode                      = 0x36,
+    set_scroll_start                      = 0x37,
+    exit_idle_mode                        = 0x38,
+    enter_idle_mode                       = 0x39,
+    set_pixel_format                      = 0x3a,
+    write_memory_continue                 = 0x3c,
+    read_memory_continue                  = 0x3e,
+    set_tear_scanline                     = 0x44,
+    get_scanline                          = 0x45,
+    Read_ID1                              = 0xda,
+    Read_ID2                              = 0xdb,
+    Read_ID3                              = 0xdc,
+    GAM_R_SEL                             = 0xf2,
+    NEGATIVE_GAMMA_CORRECT                = 0xE1,
+    POSITIVE_GAMMA_CORRECT                = 0xE0,
+    POWER_CONTROL1                        = 0xC0,
+    POWER_CONTROL2                        = 0xC1,
+    POWER_CONTROL3                        = 0xC2,
+    POWER_CONTROL4                        = 0xC3,
+    POWER_CONTROL5                        = 0xC4,
+    VCOM_CONTROL1                         = 0xC5,
+    VCOM_CONTROL2                         = 0xC6,
+    VCOM_OFFSET_CONTROL                   = 0xC7,
+    FRAME_RATE_CONTROL1                   = 0xB1,
+    FRAME_RATE_CONTROL2                   = 0xB2,
+    FRAME_RATE_CONTROL3                   = 0xB3,
+    DISPLAY_INVERSION                     = 0xB4,
+    SOURCE_DRIVER_DIRECTION               = 0xB7,
+    GATE_DRIVER_DIRECTION                 = 0xB8,
+    WRITE_ID4_VALUE                       = 0xD3,
+    NV_MEMORY_FUNCTION1                   = 0xD7,
+    NV_MEMORY_FUNCTION2                   = 0xDE
+};
+
+#endif //ILI9163_COMMANDS_HPP
@@ -0,0 +1,251 @@
+// ==========================================================================
+//
+// Author    : Mohammad Hawari
+// File      : ILI9163_display_list.cpp
+// Part of   : ILI9163 library for controlling a ILI9163 LCD display
+// Copyright : Mohammad Hawari 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// ==========================================================================
+
+#include "ILI9163_display_list.hpp"
+
+///@file
+
+// record types, each is followed by its operands
+enum class display_list_op : uint8_t {
+    command = 1,    // command byte
+    data    = 2,    // n (1 .. 255), n data bytes
+    window  = 3,    // x1, y1, x2, y2
+    fill    = 4,    // colour high, colour low, n low, n high
+    pixels  = 5     // n (1 .. 127), 2 * n pixel bytes
+};
+
+// display size
+static auto constexpr wsize = hwlib::xy(130, 129);
+
+/// ILI9163_display_list constructor
+///
+/// construct by providing the buffer that will hold the records
+ILI9163_display_list::ILI9163_display_list(uint8_t * buffer, size_t capacity):
+    buffer( buffer ),
+    capacity( capacity ),
+    used( 0 ),
+    last_data( capacity ),
+    full( false )
+{}
+
+bool ILI9163_display_list::reserve(size_t n){
+    if(full || capacity - used < n){
+        full = true;
+        return false;
+    }
+    return true;
+}
+
+void ILI9163_display_list::clear(){
+    used = 0;
+    last_data = capacity;
+    full = false;
+}
+
+void ILI9163_display_list::command(ILI9163_commands c){
+    if(reserve(2)){
+        buffer[used++] = (uint8_t) display_list_op::command;
+        buffer[used++] = static_cast< uint8_t >( c );
+        last_data = capacity;
+    }
+}
+
+void ILI9163_display_list::parameter(uint8_t p){
+    // extend the previous data record when it is the last record
+    if(last_data != capacity && buffer[last_data + 1] < 255 && last_data + 2 + buffer[last_data + 1] == used){
+        if(reserve(1)){
+            buffer[used++] = p;
+            buffer[last_data + 1]++;
+        }
+        return;
+    }
+    if(reserve(3)){
+        last_data = used;
+        buffer[used++] = (uint8_t) display_list_op::data;
+        buffer[used++] = 1;
+        buffer[used++] = p;
+    }
+}
+
+void ILI9163_display_list::data16(uint16_t d){
+    parameter(d >> 8);
+    parameter(d & 0xff);
+}
+
+bool ILI9163_display_list::window(int x1, int y1, int x2, int y2){
+    if(x1 < 0){ x1 = 0; }
+    if(y1 < 0){ y1 = 0; }
+    if(x2 >= wsize.x){ x2 = wsize.x - 1; }
+    if(y2 >= wsize.y){ y2 = wsize.y - 1; }
+    if(x1 > x2 || y1 > y2){
+        return false;
+    }
+    if(reserve(5)){
+        buffer[used++] = (uint8_t) display_list_op::window;
+        buffer[used++] = x1;
+        buffer[used++] = y1;
+        buffer[used++] = x2;
+        buffer[used++] = y2;
+        last_data = capacity;
+    }
+    return true;
+}
+
+void ILI9163_display_list::fill(uint16_t colour, uint16_t n){
+    if(n == 0){
+        return;
+    }
+    if(reserve(5)){
+        buffer[used++] = (uint8_t) display_list_op::fill;
+        buffer[used++] = colour >> 8;
+        buffer[used++] = colour & 0xff;
+        buffer[used++] = n & 0xff;
+        buffer[used++] = n >> 8;
+        last_data = capacity;
+    }
+}
+
+void ILI9163_display_list::pixels(const uint16_t data[], size_t n){
+    while(n > 0){
+        size_t chunk = n < 127 ? n : 127;
+        if(!reserve(2 + 2 * chunk)){
+            return;
+        }
+        buffer[used++] = (uint8_t) display_list_op::pixels;
+        buffer[used++] = chunk;
+        for(size_t i = 0; i < chunk; i++){
+            buffer[used++] = data[i] >> 8;
+            buffer[used++] = data[i] & 0xff;
+        }
+        data += chunk;
+        n -= chunk;
+    }
+    last_data = capacity;
+}
+
+void ILI9163_display_list::fill_rect(hwlib::xy pos, hwlib::xy size, uint16_t colour){
+    int x1 = pos.x + size.x - 1 < wsize.x ? pos.x + size.x - 1 : wsize.x - 1;
+    int y1 = pos.y + size.y - 1 < wsize.y ? pos.y + size.y - 1 : wsize.y - 1;
+    int x0 = pos.x < 0 ? 0 : pos.x;
+    int y0 = pos.y < 0 ? 0 : pos.y;
+    if(window(x0, y0, x1, y1)){
+        fill(colour, (x1 - x0 + 1) * (y1 - y0 + 1));
+    }
+}
+
+//========================================================================================================
+
+void ILI9163_display_list::replay(ILI9163_spi_res_wrx_cs & display) const {
+    // a marker, the transfers of the list follow as their own records
+    display.trace_end(display.trace_start(), ILI9163_trace_kind::list, 0, used, 0);
+
+    bool dc = false;
+    display.wrx.write(0);
+    display.wrx.flush();
+    auto t = display.bus.transaction( display.cs );
+
+    // only switch wrx between command and data
+    auto mode = [&](bool data){
+        if(data != dc){
+            display.wrx.write(data);
+            display.wrx.flush();
+            dc = data;
+        }
+    };
+
+    size_t i = 0;
+    while(i < used){
+        auto start = display.trace_start();
+        switch((display_list_op) buffer[i]){
+
+            case display_list_op::command:
+                mode(false);
+                t.write(buffer[i + 1]);
+                display.trace_end(start, ILI9163_trace_kind::command, buffer[i + 1], 1, 0);
+                i += 2;
+                break;
+
+            case display_list_op::data:
+                mode(true);
+                t.write(buffer[i + 1], buffer + i + 2);
+                // the first byte carries the time of the record
+                for(int j = 0; j < buffer[i + 1]; j++){
+                    display.trace_end(j == 0 ? start : display.trace_start(), ILI9163_trace_kind::parameter, buffer[i + 2 + j], 1, 0);
+                }
+                i += 2 + buffer[i + 1];
+                break;
+
+            case display_list_op::window: {
+                const uint8_t columns[] = { 0, buffer[i + 1], 0, buffer[i + 3] };
+                const uint8_t pages[] = { 0, buffer[i + 2], 0, buffer[i + 4] };
+                mode(false);
+                t.write( static_cast< uint8_t >( ILI9163_commands::set_column_address ) );
+                mode(true);
+                t.write(sizeof(columns), columns);
+                mode(false);
+                t.write( static_cast< uint8_t >( ILI9163_commands::set_page_address ) );
+                mode(true);
+                t.write(sizeof(pages), pages);
+                mode(false);
+                t.write( static_cast< uint8_t >( ILI9163_commands::write_memory_start ) );
+                display.trace_end(start, ILI9163_trace_kind::window, 0,
+                                  buffer[i + 1] << 8 | buffer[i + 3], buffer[i + 2] << 8 | buffer[i + 4]);
+                i += 5;
+                break;
+            }
+
+            case display_list_op::fill: {
+                uint8_t bytes[64];
+                for(size_t j = 0; j < sizeof(bytes); j += 2){
+                    bytes[j] = buffer[i + 1];
+                    bytes[j + 1] = buffer[i + 2];
+                }
+                size_t n = buffer[i + 3] | (buffer[i + 4] << 8);
+                mode(true);
+                while(n > 0){
+                    size_t chunk = n < sizeof(bytes) / 2 ? n : sizeof(bytes) / 2;
+                    t.write(2 * chunk, bytes);
+                    n -= chunk;
+                }
+                display.trace_end(start, ILI9163_trace_kind::fill, 0,
+                                  buffer[i + 3] | (buffer[i + 4] << 8), buffer[i + 1] << 8 | buffer[i + 2]);
+                i += 5;
+                break;
+            }
+
+            case display_list_op::pixels: {
+                auto position = display.trace_pixels();
+                if(display.trace != nullptr){
+                    display.trace->add_pixel_bytes(buffer + i + 2, buffer[i + 1]);
+                    start = display.trace_start();
+                }
+                mode(true);
+                t.write(2 * buffer[i + 1], buffer + i + 2);
+                display.trace_end(start, ILI9163_trace_kind::pixels, 0,
+                                  buffer[i + 1], buffer[i + 2] << 8 | buffer[i + 3], position);
+                i += 2 + 2 * buffer[i + 1];
+                break;
+            }
+
+            default:
+                // not a record, stop
+                i = used;
+                break;
+        }
+    }
+
+    // the controller cursor no longer matches pixels_byte_write
+    display.cursor = hwlib::xy(255, 255);
+}
+
+//========================================================================================================
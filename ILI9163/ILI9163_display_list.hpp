@@ -0,0 +1,91 @@
+// ==========================================================================
+//
+// Author    : Mohammad Hawari
+// File      : ILI9163_display_list.hpp
+// Part of   : ILI9163 library for controlling a ILI9163 LCD display
+// Copyright : Mohammad Hawari 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// ==========================================================================
+
+#ifndef ILI9163_DISPLAY_LIST_HPP
+#define ILI9163_DISPLAY_LIST_HPP
+
+#include "hwlib.hpp"
+#include "ILI9163.hpp"
+
+///@file
+
+/// \brief
+/// recorded display commands
+/// \details
+/// Records commands, parameters, address windows and pixel runs
+/// into a compact byte buffer supplied by the caller.
+/// replay() sends the whole list in a single transaction and only
+/// switches wrx where the list goes from command to data or back,
+/// where the driver uses a transaction per command or parameter.
+/// A list can be replayed any number of times, to any display,
+/// eg a prerecorded HUD.
+///
+/// When the buffer is full further records are dropped and
+/// overflow() returns true.
+class ILI9163_display_list {
+private:
+    uint8_t * buffer;
+    size_t capacity;
+    size_t used;
+    size_t last_data;       // start of the last data record, or capacity
+    bool full;
+
+    bool reserve(size_t n);
+
+public:
+    ILI9163_display_list(uint8_t * buffer, size_t capacity);
+
+    /// remove all records
+    void clear();
+
+    /// record a command
+    void command(ILI9163_commands c);
+
+    /// record an 8 bit parameter or data byte
+    void parameter(uint8_t p);
+
+    /// record 16 bit data
+    void data16(uint16_t d);
+
+    /// \brief
+    /// record an address window and the start of a memory write
+    /// \details
+    /// The corners are inclusive and the window is clipped to the display.
+    /// Returns false, and records nothing, when no part of it is visible.
+    /// Record as many pixels as the clipped window holds.
+    bool window(int x1, int y1, int x2, int y2);
+
+    /// record n pixels of one colour
+    void fill(uint16_t colour, uint16_t n);
+
+    /// record n different pixels
+    void pixels(const uint16_t data[], size_t n);
+
+    /// record a filled rectangle (a window and a fill), clipped to the display
+    void fill_rect(hwlib::xy pos, hwlib::xy size, uint16_t colour);
+
+    /// send the list to a display
+    void replay(ILI9163_spi_res_wrx_cs & display) const;
+
+    /// bytes used by the records
+    size_t size() const {
+        return used;
+    }
+
+    /// true when records were dropped because the buffer was full
+    bool overflow() const {
+        return full;
+    }
+};
+
+#endif //ILI9163_DISPLAY_LIST_HPP
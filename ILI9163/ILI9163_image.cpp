@@ -0,0 +1,234 @@
+// ==========================================================================
+//
+// Author    : Mohammad Hawari
+// File      : ILI9163_image.cpp
+// Part of   : ILI9163 library for controlling a ILI9163 LCD display
+// Copyright : Mohammad Hawari 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// ==========================================================================
+
+#include "ILI9163_image.hpp"
+#include "ILI9163_rgb565.hpp"
+
+///@file
+
+size_t ILI9163_memory_reader::read(uint8_t buffer[], size_t n){
+    if(n > size - position){
+        n = size - position;
+    }
+    for(size_t i = 0; i < n; i++){
+        buffer[i] = data[position + i];
+    }
+    position += n;
+    return n;
+}
+
+//========================================================================================================
+
+// display size
+static auto constexpr wsize = hwlib::xy(130, 129);
+
+// largest width and height accepted from a header, so the row
+// arithmetic can not overflow on a damaged or hostile file
+static int constexpr max_size = 64 * wsize.x;
+
+// read exactly n bytes
+static bool read_all(ILI9163_byte_reader & reader, uint8_t data[], size_t n){
+    while(n > 0){
+        size_t got = reader.read(data, n);
+        if(got == 0){
+            return false;
+        }
+        data += got;
+        n -= got;
+    }
+    return true;
+}
+
+// read and drop n bytes
+static bool skip(ILI9163_byte_reader & reader, size_t n){
+    uint8_t scratch[16];
+    while(n > 0){
+        size_t chunk = n < sizeof(scratch) ? n : sizeof(scratch);
+        if(!read_all(reader, scratch, chunk)){
+            return false;
+        }
+        n -= chunk;
+    }
+    return true;
+}
+
+// the layout of the pixels in an image file
+struct image_format {
+    int width;
+    int height;
+    bool bottom_up;     // BMP rows are stored bottom row first
+    bool bgr;           // BMP pixels are stored blue, green, red
+    int padding;        // bytes after each row
+    int maxval;         // largest sample value (PPM)
+};
+
+// decode the pixel rows and send them to the display
+static bool stream_rows(ILI9163_spi_res_wrx_cs & display, ILI9163_byte_reader & reader,
+                        hwlib::xy pos, const image_format & format){
+
+    // visible columns
+    int x0 = pos.x < 0 ? 0 : pos.x;
+    int x1 = pos.x + format.width < wsize.x ? pos.x + format.width : wsize.x;
+
+    uint16_t row[wsize.x];
+    uint8_t chunk[3 * 16];
+    bool window = false;
+
+    for(int i = 0; i < format.height; i++){
+        int y = pos.y + (format.bottom_up ? format.height - 1 - i : i);
+        bool visible = x0 < x1 && y >= 0 && y < wsize.y;
+
+        if(!visible){
+            if(!skip(reader, 3 * format.width + format.padding)){
+                return false;
+            }
+            window = false;
+            continue;
+        }
+
+        for(int x = 0; x < format.width; ){
+            int n = format.width - x < 16 ? format.width - x : 16;
+            if(!read_all(reader, chunk, 3 * n)){
+                return false;
+            }
+            for(int j = 0; j < n; j++){
+                int column = pos.x + x + j;
+                if(column < x0 || column >= x1){
+                    continue;
+                }
+                int r = chunk[3 * j + (format.bgr ? 2 : 0)];
+                int g = chunk[3 * j + 1];
+                int b = chunk[3 * j + (format.bgr ? 0 : 2)];
+                if(format.maxval != 255){
+                    r = r * 255 / format.maxval;
+                    g = g * 255 / format.maxval;
+                    b = b * 255 / format.maxval;
+                }
+                row[column - x0] = rgb565_from_color(hwlib::color(r, g, b));
+            }
+            x += n;
+        }
+        if(!skip(reader, format.padding)){
+            return false;
+        }
+
+        // top-down rows follow each other in one window,
+        // bottom-up rows each get their own
+        if(!window){
+            int last = format.bottom_up ? y : pos.y + format.height - 1;
+            display.setAddress(x0, y, x1 - 1, last < wsize.y ? last : wsize.y - 1);
+            window = !format.bottom_up;
+        }
+        display.pixels(row, x1 - x0);
+    }
+    return true;
+}
+
+//========================================================================================================
+
+static uint32_t le16(const uint8_t * p){
+    return p[0] | (p[1] << 8);
+}
+
+static uint32_t le32(const uint8_t * p){
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t) p[3] << 24);
+}
+
+bool ILI9163_draw_bmp(ILI9163_spi_res_wrx_cs & display, ILI9163_byte_reader & reader, hwlib::xy pos){
+
+    // file header (14 bytes) and BITMAPINFOHEADER (40 bytes)
+    uint8_t header[54];
+    if(!read_all(reader, header, sizeof(header))){
+        return false;
+    }
+    if(header[0] != 'B' || header[1] != 'M'){
+        return false;
+    }
+    uint32_t offset = le32(header + 10);
+    int32_t width = (int32_t) le32(header + 18);
+    int32_t height = (int32_t) le32(header + 22);
+    if(le32(header + 14) < 40 || le16(header + 26) != 1 || le16(header + 28) != 24
+       || le32(header + 30) != 0 || offset < sizeof(header)){
+        return false;
+    }
+    // a negative height is a top-down file, checked before it is negated
+    if(width < 1 || width > max_size || height == 0 || height < -max_size || height > max_size){
+        return false;
+    }
+    if(!skip(reader, offset - sizeof(header))){
+        return false;
+    }
+
+    image_format format;
+    format.width = width;
+    format.height = height < 0 ? -height : height;
+    format.bottom_up = height > 0;
+    format.bgr = true;
+    format.padding = (4 - (3 * width) % 4) % 4;
+    format.maxval = 255;
+    return stream_rows(display, reader, pos, format);
+}
+
+// read a PPM header number, skipping white space and comments
+static bool ppm_number(ILI9163_byte_reader & reader, int & value){
+    uint8_t c;
+    for(;;){
+        if(!read_all(reader, &c, 1)){
+            return false;
+        }
+        if(c == '#'){
+            while(c != '\n'){
+                if(!read_all(reader, &c, 1)){
+                    return false;
+                }
+            }
+        } else if(c != ' ' && c != '\t' && c != '\r' && c != '\n'){
+            break;
+        }
+    }
+    if(c < '0' || c > '9'){
+        return false;
+    }
+    value = 0;
+    // the single white space byte after the number is read as well
+    while(c >= '0' && c <= '9'){
+        value = 10 * value + (c - '0');
+        if(value > 65535 || !read_all(reader, &c, 1)){
+            return false;
+        }
+    }
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+bool ILI9163_draw_ppm(ILI9163_spi_res_wrx_cs & display, ILI9163_byte_reader & reader, hwlib::xy pos){
+    uint8_t magic[2];
+    if(!read_all(reader, magic, 2) || magic[0] != 'P' || magic[1] != '6'){
+        return false;
+    }
+
+    image_format format;
+    if(!ppm_number(reader, format.width) || !ppm_number(reader, format.height)
+       || !ppm_number(reader, format.maxval)){
+        return false;
+    }
+    if(format.width < 1 || format.width > max_size || format.height < 1 || format.height > max_size
+       || format.maxval <= 0 || format.maxval > 255){
+        return false;
+    }
+    format.bottom_up = false;
+    format.bgr = false;
+    format.padding = 0;
+    return stream_rows(display, reader, pos, format);
+}
+
+//========================================================================================================
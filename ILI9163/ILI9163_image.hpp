@@ -0,0 +1,92 @@
+// ==========================================================================
+//
+// Author    : Mohammad Hawari
+// File      : ILI9163_image.hpp
+// Part of   : ILI9163 library for controlling a ILI9163 LCD display
+// Copyright : Mohammad Hawari 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// ==========================================================================
+
+#ifndef ILI9163_IMAGE_HPP
+#define ILI9163_IMAGE_HPP
+
+#include "hwlib.hpp"
+#include "ILI9163.hpp"
+
+#ifdef BMPTK_TARGET_native
+#include <cstdio>
+#endif
+
+///@file
+
+/// \brief
+/// source of image bytes
+/// \details
+/// The image decoders read their input through this interface,
+/// so an image can come from a flash array or (on the host) a file.
+class ILI9163_byte_reader {
+public:
+    /// read up to n bytes into data, returns the number of bytes read (0 at the end)
+    virtual size_t read(uint8_t data[], size_t n) = 0;
+};
+
+/// reads from an array in memory, eg a const array in flash
+class ILI9163_memory_reader : public ILI9163_byte_reader {
+private:
+    const uint8_t * data;
+    size_t size;
+    size_t position;
+
+public:
+    ILI9163_memory_reader(const uint8_t * data, size_t size):
+        data( data ),
+        size( size ),
+        position( 0 )
+    {}
+
+    size_t read(uint8_t buffer[], size_t n) override;
+};
+
+#ifdef BMPTK_TARGET_native
+
+/// reads from an open file, host only
+class ILI9163_file_reader : public ILI9163_byte_reader {
+private:
+    std::FILE * file;
+
+public:
+    ILI9163_file_reader(std::FILE * file):
+        file( file )
+    {}
+
+    size_t read(uint8_t buffer[], size_t n) override {
+        return std::fread(buffer, 1, n, file);
+    }
+};
+
+#endif
+
+/// \brief
+/// draw an uncompressed 24 bit BMP image with its top left corner at pos
+/// \details
+/// The image is decoded one row at a time and each row is sent
+/// through its own address window, so bottom-up files need no frame buffer.
+/// Parts outside the display are clipped.
+/// Returns false when the file is not a 24 bit uncompressed BMP, is wider or
+/// higher than 64 times the display, or ends early.
+bool ILI9163_draw_bmp(ILI9163_spi_res_wrx_cs & display, ILI9163_byte_reader & reader, hwlib::xy pos);
+
+/// \brief
+/// draw a binary (P6) PPM image with its top left corner at pos
+/// \details
+/// The image is decoded one row at a time into a single address window.
+/// Parts outside the display are clipped.
+/// Returns false when the file is not a P6 PPM with a maxval up to 255, is wider
+/// or higher than 64 times the display, or ends early.
+bool ILI9163_draw_ppm(ILI9163_spi_res_wrx_cs & display, ILI9163_byte_reader & reader, hwlib::xy pos);
+
+#endif //ILI9163_IMAGE_HPP
@@ -0,0 +1,23 @@
+// ==========================================================================
+//
+// Author    : Mohammad Hawari
+// File      : ILI9163_lut.cpp
+// Part of   : ILI9163 library for controlling a ILI9163 LCD display
+// Copyright : Mohammad Hawari 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// ==========================================================================
+
+#include "ILI9163_lut.hpp"
+
+///@file
+
+void ILI9163_lut::write(ILI9163_spi_res_wrx_cs & display) const {
+    display.command(ILI9163_commands::write_LUT);
+    display.data(entries, size);
+}
+
+//========================================================================================================
@@ -0,0 +1,167 @@
+// ==========================================================================
+//
+// Author    : Mohammad Hawari
+// File      : ILI9163_lut.hpp
+// Part of   : ILI9163 library for controlling a ILI9163 LCD display
+// Copyright : Mohammad Hawari 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// ==========================================================================
+
+#ifndef ILI9163_LUT_HPP
+#define ILI9163_LUT_HPP
+
+#include "hwlib.hpp"
+#include "ILI9163.hpp"
+
+///@file
+
+/// \brief
+/// contents of the ILI9163 colour LUT
+/// \details
+/// In 16 bit mode the controller converts each pixel to 18 bits through
+/// the LUT set by write_LUT (0x2d): 32 entries for the 5 high bits of
+/// the pixel, 64 for the 6 middle bits and 32 for the 5 low bits, each
+/// entry a 6 bit level. The driver sends blue in the high bits, so the
+/// entries are in the order blue, green, red.
+///
+/// The conversion is done when a pixel is written to graphics memory:
+/// a new LUT shows on the pixels written after it, so a fade step is
+/// a LUT write followed by a redraw (eg flush() after invalidate() on
+/// the buffered window, or a clear()).
+///
+/// The tables are constexpr, so fixed effects can be computed at
+/// compile time and stored in flash.
+class ILI9163_lut {
+public:
+
+    static constexpr int blue_first = 0;
+    static constexpr int green_first = 32;
+    static constexpr int red_first = 96;
+    static constexpr int size = 128;
+
+    uint8_t entries[size];
+
+    /// all entries 0: every pixel shows black
+    constexpr ILI9163_lut():
+        entries{}
+    {}
+
+    /// every pixel shows as itself
+    static constexpr ILI9163_lut identity(){
+        ILI9163_lut lut;
+        for(int i = 0; i < 32; i++){
+            // 5 bits to 6, the top bit is repeated at the bottom so 31 becomes 63
+            lut.entries[blue_first + i] = (uint8_t) (i << 1 | i >> 4);
+            lut.entries[red_first + i] = (uint8_t) (i << 1 | i >> 4);
+        }
+        for(int i = 0; i < 64; i++){
+            lut.entries[green_first + i] = (uint8_t) i;
+        }
+        return lut;
+    }
+
+    /// every pixel shows in colour red, green, blue (8 bit levels)
+    static constexpr ILI9163_lut solid(uint8_t red, uint8_t green, uint8_t blue){
+        ILI9163_lut lut;
+        for(int i = 0; i < 32; i++){
+            lut.entries[blue_first + i] = blue >> 2;
+            lut.entries[red_first + i] = red >> 2;
+        }
+        for(int i = 0; i < 64; i++){
+            lut.entries[green_first + i] = green >> 2;
+        }
+        return lut;
+    }
+
+    /// every pixel shows as its complement
+    static constexpr ILI9163_lut inverted(){
+        auto lut = identity();
+        for(int i = 0; i < size; i++){
+            lut.entries[i] = 63 - lut.entries[i];
+        }
+        return lut;
+    }
+
+    /// \brief
+    /// the LUT at position step of steps from this one to target
+    /// \details
+    /// Each entry moves in a straight line and is rounded to the nearest
+    /// level, step 0 gives this LUT and step == steps gives target.
+    constexpr ILI9163_lut mix(const ILI9163_lut & target, unsigned int step, unsigned int steps) const {
+        ILI9163_lut lut;
+        if(step >= steps){
+            return target;
+        }
+        for(int i = 0; i < size; i++){
+            int from = entries[i];
+            int delta = (int) target.entries[i] - from;
+            int scaled = delta * (int) step;
+            // round half away from zero, so the curve is symmetric for fades in and out
+            scaled += scaled < 0 ? -(int) (steps / 2) : (int) (steps / 2);
+            lut.entries[i] = (uint8_t) (from + scaled / (int) steps);
+        }
+        return lut;
+    }
+
+    /// every pixel at level / 255 of its brightness
+    static constexpr ILI9163_lut brightness(uint8_t level){
+        return solid(0, 0, 0).mix(identity(), level, 255);
+    }
+
+    /// every pixel mixed amount / 255 of the way to colour red, green, blue
+    static constexpr ILI9163_lut tint(uint8_t red, uint8_t green, uint8_t blue, uint8_t amount){
+        return identity().mix(solid(red, green, blue), amount, 255);
+    }
+
+    /// send the table to the display
+    void write(ILI9163_spi_res_wrx_cs & display) const;
+};
+
+/// \brief
+/// precomputed steps of a fade between two colour LUTs
+/// \details
+/// Holds STEPS + 1 tables of 128 bytes, step 0 is from and step STEPS is
+/// to. A constexpr fade is computed by the compiler, so a step costs only
+/// the 128 byte LUT write:
+///
+///     static constexpr auto fade_out = ILI9163_lut_fade< 16 >(
+///         ILI9163_lut::identity(), ILI9163_lut::solid(0, 0, 0) );
+///     for(unsigned int i = 0; i < fade_out.count; i++){
+///         fade_out.write(display, i);
+///         display.clear(hwlib::red);
+///     }
+template< unsigned int STEPS >
+class ILI9163_lut_fade {
+private:
+    static_assert( STEPS >= 1, "a fade needs at least one step" );
+
+    ILI9163_lut tables[STEPS + 1];
+
+public:
+
+    static constexpr unsigned int count = STEPS + 1;
+
+    constexpr ILI9163_lut_fade(const ILI9163_lut & from, const ILI9163_lut & to):
+        tables{}
+    {
+        for(unsigned int i = 0; i <= STEPS; i++){
+            tables[i] = from.mix(to, i, STEPS);
+        }
+    }
+
+    /// the table for step i, steps past the end give the last table
+    constexpr const ILI9163_lut & operator[](unsigned int i) const {
+        return tables[i < STEPS ? i : STEPS];
+    }
+
+    /// send the table for step i to the display
+    void write(ILI9163_spi_res_wrx_cs & display, unsigned int i) const {
+        (*this)[i].write(display);
+    }
+};
+
+#endif //ILI9163_LUT_HPP
@@ -0,0 +1,80 @@
+// ==========================================================================
+//
+// Author    : Mohammad Hawari
+// File      : ILI9163_power.cpp
+// Part of   : ILI9163 library for controlling a ILI9163 LCD display
+// Copyright : Mohammad Hawari 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// ==========================================================================
+
+#include "ILI9163_power.hpp"
+
+///@file
+
+/// ILI9163_frame_pacer constructor
+///
+/// construct by providing the frame rate, the first frame starts now
+ILI9163_frame_pacer::ILI9163_frame_pacer(uint_fast32_t hz):
+    period_us( 1'000'000 / (hz == 0 ? 1 : hz) ),
+    next_us( 0 ),
+    frame_start_us( 0 ),
+    total_active_us( 0 ),
+    total_sleep_us( 0 ),
+    frame_count( 0 ),
+    late_count( 0 )
+{
+    restart();
+}
+
+uint_fast64_t ILI9163_frame_pacer::now_us(){
+    return hwlib::now_us();
+}
+
+void ILI9163_frame_pacer::sleep_until(uint_fast64_t us){
+#ifdef BMPTK_TARGET_arduino_due
+    (void) us;
+    __WFI();
+#else
+    auto now = hwlib::now_us();
+    if(us > now){
+        hwlib::wait_us((int_fast32_t) (us - now));
+    }
+#endif
+}
+
+void ILI9163_frame_pacer::restart(){
+    frame_start_us = now_us();
+    next_us = frame_start_us + period_us;
+}
+
+void ILI9163_frame_pacer::wait(){
+    auto now = now_us();
+    total_active_us += now - frame_start_us;
+    frame_count++;
+
+    if(now >= next_us){
+        late_count++;
+        next_us = now;
+    } else{
+        auto start = now;
+        while(now < next_us){
+            sleep_until(next_us);
+            now = now_us();
+        }
+        total_sleep_us += now - start;
+    }
+
+    frame_start_us = now;
+    next_us += period_us;
+}
+
+uint_fast32_t ILI9163_frame_pacer::duty_percent() const {
+    auto total = total_active_us + total_sleep_us;
+    return total == 0 ? 100 : (100 * total_active_us) / total;
+}
+
+//========================================================================================================
@@ -0,0 +1,85 @@
+// ==========================================================================
+//
+// Author    : Mohammad Hawari
+// File      : ILI9163_power.hpp
+// Part of   : ILI9163 library for controlling a ILI9163 LCD display
+// Copyright : Mohammad Hawari 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// ==========================================================================
+
+#ifndef ILI9163_POWER_HPP
+#define ILI9163_POWER_HPP
+
+#include "hwlib.hpp"
+
+///@file
+
+/// \brief
+/// frame pacing with sleep between the frames
+/// \details
+/// Call wait() once per frame. It sleeps the CPU until the next frame
+/// is due: on the Due with WFI, so some interrupt (eg a timer) must
+/// wake it up regularly, on the host with hwlib::wait_us.
+/// The time spent working and sleeping is accounted, to estimate
+/// the power used by the application.
+/// When a frame takes longer than the period the schedule restarts
+/// from the end of that frame instead of trying to catch up.
+///
+/// The clock and the sleep are virtual, so a derived pacer can run on
+/// another time source, such as a simulated clock in a host check.
+class ILI9163_frame_pacer {
+private:
+    uint_fast64_t period_us;
+    uint_fast64_t next_us;
+    uint_fast64_t frame_start_us;
+    uint_fast64_t total_active_us;
+    uint_fast64_t total_sleep_us;
+    uint_fast32_t frame_count;
+    uint_fast32_t late_count;
+
+protected:
+    /// the time in us
+    virtual uint_fast64_t now_us();
+
+    /// sleep until the time is us, or until some interrupt wakes the CPU earlier
+    virtual void sleep_until(uint_fast64_t us);
+
+public:
+    ILI9163_frame_pacer(uint_fast32_t hz);
+
+    virtual ~ILI9163_frame_pacer() = default;
+
+    /// end the current frame and sleep until the next one
+    void wait();
+
+    /// start a new schedule with a frame that starts now, the totals are kept
+    void restart();
+
+    /// time spent between wait() calls
+    uint_fast64_t active_us() const {
+        return total_active_us;
+    }
+
+    /// time spent sleeping in wait()
+    uint_fast64_t sleep_us() const {
+        return total_sleep_us;
+    }
+
+    /// number of frames, and the frames that took longer than the period
+    uint_fast32_t frames() const {
+        return frame_count;
+    }
+
+    uint_fast32_t late_frames() const {
+        return late_count;
+    }
+
+    /// active time as a percentage of the total time
+    uint_fast32_t duty_percent() const;
+};
+
+#endif //ILI9163_POWER_HPP
@@ -0,0 +1,231 @@
+// ==========================================================================
+//
+// Author    : Mohammad Hawari
+// File      : ILI9163_raster.cpp
+// Part of   : ILI9163 library for controlling a ILI9163 LCD display
+// Copyright : Mohammad Hawari 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// ==========================================================================
+
+#include "ILI9163_raster.hpp"
+
+///@file
+
+// display size
+static auto constexpr wsize = hwlib::xy(130, 129);
+
+// fill the window x0, y0 .. x1, y1 (inclusive, any order) after clipping
+static void fill_window(ILI9163_spi_res_wrx_cs & display, int x0, int y0, int x1, int y1, uint16_t colour){
+    if(x0 > x1){ int t = x0; x0 = x1; x1 = t; }
+    if(y0 > y1){ int t = y0; y0 = y1; y1 = t; }
+    if(x0 < 0){ x0 = 0; }
+    if(y0 < 0){ y0 = 0; }
+    if(x1 >= wsize.x){ x1 = wsize.x - 1; }
+    if(y1 >= wsize.y){ y1 = wsize.y - 1; }
+    if(x0 > x1 || y0 > y1){
+        return;
+    }
+    display.setAddress(x0, y0, x1, y1);
+    display.fill(colour, (size_t) (x1 - x0 + 1) * (y1 - y0 + 1));
+}
+
+void ILI9163_hline(ILI9163_spi_res_wrx_cs & display, int x0, int x1, int y, uint16_t colour){
+    fill_window(display, x0, y, x1, y, colour);
+}
+
+void ILI9163_vline(ILI9163_spi_res_wrx_cs & display, int x, int y0, int y1, uint16_t colour){
+    fill_window(display, x, y0, x, y1, colour);
+}
+
+void ILI9163_fill_rect(ILI9163_spi_res_wrx_cs & display, hwlib::xy pos, hwlib::xy size, uint16_t colour){
+    if(size.x > 0 && size.y > 0){
+        fill_window(display, pos.x, pos.y, pos.x + size.x - 1, pos.y + size.y - 1, colour);
+    }
+}
+
+//========================================================================================================
+
+void ILI9163_line(ILI9163_spi_res_wrx_cs & display, hwlib::xy a, hwlib::xy b, uint16_t colour){
+    int dx = b.x > a.x ? b.x - a.x : a.x - b.x;
+    int dy = b.y > a.y ? b.y - a.y : a.y - b.y;
+    int sx = b.x > a.x ? 1 : -1;
+    int sy = b.y > a.y ? 1 : -1;
+
+    if(dx >= dy){
+        // mostly horizontal: a run ends where y steps
+        int err = dx / 2;
+        int y = a.y;
+        int start = a.x;
+        for(int x = a.x; x != b.x; x += sx){
+            err -= dy;
+            if(err < 0){
+                ILI9163_hline(display, start, x, y, colour);
+                y += sy;
+                err += dx;
+                start = x + sx;
+            }
+        }
+        ILI9163_hline(display, start, b.x, y, colour);
+    } else{
+        // mostly vertical: a run ends where x steps
+        int err = dy / 2;
+        int x = a.x;
+        int start = a.y;
+        for(int y = a.y; y != b.y; y += sy){
+            err -= dx;
+            if(err < 0){
+                ILI9163_vline(display, x, start, y, colour);
+                x += sx;
+                err += dy;
+                start = y + sy;
+            }
+        }
+        ILI9163_vline(display, x, start, b.y, colour);
+    }
+}
+
+void ILI9163_circle(ILI9163_spi_res_wrx_cs & display, hwlib::xy center, int radius, uint16_t colour){
+    if(radius < 0){
+        return;
+    }
+    int cx = center.x;
+    int cy = center.y;
+    int x = 0;
+    int y = radius;
+    int d = 1 - radius;
+    int start = 0;
+
+    // walk one octant, x start .. x is a run on row y
+    while(x <= y){
+        int next_x = x + 1;
+        int next_y = y;
+        if(d < 0){
+            d += 2 * x + 3;
+        } else{
+            d += 2 * (x - y) + 5;
+            next_y = y - 1;
+        }
+
+        if(next_y != y || next_x > next_y){
+            if(start == 0){
+                // the top and bottom runs cross the middle
+                ILI9163_hline(display, cx - x, cx + x, cy - y, colour);
+                ILI9163_hline(display, cx - x, cx + x, cy + y, colour);
+                ILI9163_vline(display, cx - y, cy - x, cy + x, colour);
+                ILI9163_vline(display, cx + y, cy - x, cy + x, colour);
+            } else{
+                ILI9163_hline(display, cx + start, cx + x, cy - y, colour);
+                ILI9163_hline(display, cx - x, cx - start, cy - y, colour);
+                ILI9163_hline(display, cx + start, cx + x, cy + y, colour);
+                ILI9163_hline(display, cx - x, cx - start, cy + y, colour);
+                ILI9163_vline(display, cx + y, cy + start, cy + x, colour);
+                ILI9163_vline(display, cx + y, cy - x, cy - start, colour);
+                ILI9163_vline(display, cx - y, cy + start, cy + x, colour);
+                ILI9163_vline(display, cx - y, cy - x, cy - start, colour);
+            }
+            start = next_x;
+        }
+
+        x = next_x;
+        y = next_y;
+    }
+}
+
+// fill a circle that is stretched: the top half is centered on
+// x0 .. x1, y0 and the bottom half on x0 .. x1, y1
+static void fill_stretched_circle(ILI9163_spi_res_wrx_cs & display, int x0, int x1, int y0, int y1,
+                                  int radius, uint16_t colour){
+    auto rows = [&](int dy, int half_width){
+        ILI9163_hline(display, x0 - half_width, x1 + half_width, y0 - dy, colour);
+        if(y1 + dy != y0 - dy){
+            ILI9163_hline(display, x0 - half_width, x1 + half_width, y1 + dy, colour);
+        }
+    };
+
+    int x = 0;
+    int y = radius;
+    int d = 1 - radius;
+    while(x <= y){
+        // rows x away from the middle are y wide
+        rows(x, y);
+        if(d < 0){
+            d += 2 * x + 3;
+        } else{
+            // the last (widest) run of the rows y away from the middle
+            if(x != y){
+                rows(y, x);
+            }
+            d += 2 * (x - y) + 5;
+            y--;
+        }
+        x++;
+    }
+}
+
+void ILI9163_fill_circle(ILI9163_spi_res_wrx_cs & display, hwlib::xy center, int radius, uint16_t colour){
+    if(radius >= 0){
+        fill_stretched_circle(display, center.x, center.x, center.y, center.y, radius, colour);
+    }
+}
+
+void ILI9163_fill_triangle(ILI9163_spi_res_wrx_cs & display, hwlib::xy a, hwlib::xy b, hwlib::xy c, uint16_t colour){
+
+    // sort on y: a on top, c at the bottom
+    if(a.y > b.y){ auto t = a; a = b; b = t; }
+    if(b.y > c.y){ auto t = b; b = c; c = t; }
+    if(a.y > b.y){ auto t = a; a = b; b = t; }
+
+    if(a.y == c.y){
+        int x0 = a.x < b.x ? (a.x < c.x ? a.x : c.x) : (b.x < c.x ? b.x : c.x);
+        int x1 = a.x > b.x ? (a.x > c.x ? a.x : c.x) : (b.x > c.x ? b.x : c.x);
+        ILI9163_hline(display, x0, x1, a.y, colour);
+        return;
+    }
+
+    int first = a.y < 0 ? 0 : a.y;
+    int last = c.y >= wsize.y ? wsize.y - 1 : c.y;
+    for(int y = first; y <= last; y++){
+        // x on the long edge a-c and on the short edge a-b or b-c
+        int xl = a.x + (c.x - a.x) * (y - a.y) / (c.y - a.y);
+        int xs;
+        if(y < b.y){
+            xs = a.x + (b.x - a.x) * (y - a.y) / (b.y - a.y);
+        } else if(c.y != b.y){
+            xs = b.x + (c.x - b.x) * (y - b.y) / (c.y - b.y);
+        } else{
+            xs = b.x;
+        }
+        ILI9163_hline(display, xl, xs, y, colour);
+    }
+}
+
+void ILI9163_fill_round_rect(ILI9163_spi_res_wrx_cs & display, hwlib::xy pos, hwlib::xy size,
+                             int radius, uint16_t colour){
+    if(size.x <= 0 || size.y <= 0){
+        return;
+    }
+    // the corner circles (2 * radius + 1 wide) must fit, also on an even side
+    int max = ((size.x < size.y ? size.x : size.y) - 1) / 2;
+    if(radius > max){
+        radius = max;
+    }
+    if(radius < 0){
+        radius = 0;
+    }
+
+    // the middle band between the corners
+    int y0 = pos.y + radius;
+    int y1 = pos.y + size.y - 1 - radius;
+    if(y1 - y0 > 1){
+        ILI9163_fill_rect(display, hwlib::xy(pos.x, y0 + 1), hwlib::xy(size.x, y1 - y0 - 1), colour);
+    }
+
+    // the corners, with straight runs between them
+    fill_stretched_circle(display, pos.x + radius, pos.x + size.x - 1 - radius, y0, y1, radius, colour);
+}
+
+//========================================================================================================
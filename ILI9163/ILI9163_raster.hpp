@@ -0,0 +1,59 @@
+// ==========================================================================
+//
+// Author    : Mohammad Hawari
+// File      : ILI9163_raster.hpp
+// Part of   : ILI9163 library for controlling a ILI9163 LCD display
+// Copyright : Mohammad Hawari 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// ==========================================================================
+
+#ifndef ILI9163_RASTER_HPP
+#define ILI9163_RASTER_HPP
+
+#include "hwlib.hpp"
+#include "ILI9163.hpp"
+
+///@file
+
+/// \brief
+/// span based drawing directly on the display
+/// \details
+/// These functions split a shape into horizontal or vertical runs
+/// and send every run as one address window with a single fill burst,
+/// instead of one cursor-checked write per pixel like hwlib::line and hwlib::circle.
+/// Everything is clipped to the display. Colours are in the 16 bit display format.
+
+/// draw the horizontal run x0 .. x1 (inclusive) on row y
+void ILI9163_hline(ILI9163_spi_res_wrx_cs & display, int x0, int x1, int y, uint16_t colour);
+
+/// draw the vertical run y0 .. y1 (inclusive) on column x
+void ILI9163_vline(ILI9163_spi_res_wrx_cs & display, int x, int y0, int y1, uint16_t colour);
+
+/// fill a rectangle
+void ILI9163_fill_rect(ILI9163_spi_res_wrx_cs & display, hwlib::xy pos, hwlib::xy size, uint16_t colour);
+
+/// draw a line from a to b (Bresenham, consecutive pixels merged into runs)
+void ILI9163_line(ILI9163_spi_res_wrx_cs & display, hwlib::xy a, hwlib::xy b, uint16_t colour);
+
+/// draw a circle outline (midpoint, consecutive pixels merged into runs)
+void ILI9163_circle(ILI9163_spi_res_wrx_cs & display, hwlib::xy center, int radius, uint16_t colour);
+
+/// fill a circle, one run per row
+void ILI9163_fill_circle(ILI9163_spi_res_wrx_cs & display, hwlib::xy center, int radius, uint16_t colour);
+
+/// fill a triangle, one run per row
+void ILI9163_fill_triangle(ILI9163_spi_res_wrx_cs & display, hwlib::xy a, hwlib::xy b, hwlib::xy c, uint16_t colour);
+
+/// \brief
+/// fill a rectangle with rounded corners
+/// \details
+/// The straight middle part is one window. The radius is limited to
+/// (shorter side - 1) / 2, so the corner circles fit.
+void ILI9163_fill_round_rect(ILI9163_spi_res_wrx_cs & display, hwlib::xy pos, hwlib::xy size,
+                             int radius, uint16_t colour);
+
+#endif //ILI9163_RASTER_HPP
@@ -0,0 +1,328 @@
+// ==========================================================================
+//
+// Author    : Mohammad Hawari
+// File      : ILI9163_rgb565.cpp
+// Part of   : ILI9163 library for controlling a ILI9163 LCD display
+// Copyright : Mohammad Hawari 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// ==========================================================================
+
+#include "ILI9163_rgb565.hpp"
+
+// ILI9163_RGB565_WORDS selects the 32 bit word kernels of the Due on any build
+#if defined(__SSE2__) && !defined(ILI9163_RGB565_WORDS)
+#define ILI9163_RGB565_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && !defined(ILI9163_RGB565_WORDS)
+#define ILI9163_RGB565_NEON
+#include <arm_neon.h>
+#endif
+
+///@file
+
+// two pixels, allowed to alias the uint16_t buffers
+typedef uint32_t __attribute__((__may_alias__)) rgb565_pair;
+
+// the low bit of each colour field cleared, for two pixels
+static constexpr uint32_t half_mask = 0xf7def7de;
+
+// true when p is on a 4 byte boundary
+static inline bool aligned(const uint16_t * p){
+    return (reinterpret_cast< uintptr_t >(p) & 0x03) == 0;
+}
+
+// the three colour fields of a pixel spread apart, with room for a multiply
+static inline uint32_t spread(uint16_t p){
+    return (p | ((uint32_t) p << 16)) & 0x07e0f81f;
+}
+
+static inline uint16_t unspread(uint32_t p){
+    p &= 0x07e0f81f;
+    return (uint16_t) ((p >> 16) | p);
+}
+
+//========================================================================================================
+
+void rgb565_fill(uint16_t * dst, size_t n, uint16_t colour){
+    if(n > 0 && !aligned(dst)){
+        *dst++ = colour;
+        n--;
+    }
+
+#if defined(ILI9163_RGB565_SSE2)
+    __m128i v = _mm_set1_epi16((short) colour);
+    for(; n >= 8; n -= 8, dst += 8){
+        _mm_storeu_si128(reinterpret_cast< __m128i * >(dst), v);
+    }
+#elif defined(ILI9163_RGB565_NEON)
+    uint16x8_t v = vdupq_n_u16(colour);
+    for(; n >= 8; n -= 8, dst += 8){
+        vst1q_u16(dst, v);
+    }
+#endif
+
+    uint32_t pair = colour | ((uint32_t) colour << 16);
+    rgb565_pair * d = reinterpret_cast< rgb565_pair * >(dst);
+    for(; n >= 8; n -= 8, d += 4){
+        d[0] = pair; d[1] = pair; d[2] = pair; d[3] = pair;
+    }
+    for(; n >= 2; n -= 2){
+        *d++ = pair;
+    }
+    if(n > 0){
+        *reinterpret_cast< uint16_t * >(d) = colour;
+    }
+}
+
+void rgb565_fill_rect(uint16_t * dst, int stride, int w, int h, uint16_t colour){
+    if(w <= 0 || h <= 0){
+        return;
+    }
+    if(w == stride){
+        rgb565_fill(dst, (size_t) w * h, colour);
+        return;
+    }
+    for(int y = 0; y < h; y++, dst += stride){
+        rgb565_fill(dst, w, colour);
+    }
+}
+
+void rgb565_copy(uint16_t * dst, const uint16_t * src, size_t n){
+
+#if defined(ILI9163_RGB565_SSE2)
+    for(; n >= 8; n -= 8, dst += 8, src += 8){
+        _mm_storeu_si128(reinterpret_cast< __m128i * >(dst),
+                         _mm_loadu_si128(reinterpret_cast< const __m128i * >(src)));
+    }
+#elif defined(ILI9163_RGB565_NEON)
+    for(; n >= 8; n -= 8, dst += 8, src += 8){
+        vst1q_u16(dst, vld1q_u16(src));
+    }
+#else
+    // word copies only work when both are equally (mis)aligned
+    if(aligned(dst) == aligned(src)){
+        if(n > 0 && !aligned(dst)){
+            *dst++ = *src++;
+            n--;
+        }
+        rgb565_pair * d = reinterpret_cast< rgb565_pair * >(dst);
+        const rgb565_pair * s = reinterpret_cast< const rgb565_pair * >(src);
+        for(; n >= 8; n -= 8, d += 4, s += 4){
+            d[0] = s[0]; d[1] = s[1]; d[2] = s[2]; d[3] = s[3];
+        }
+        for(; n >= 2; n -= 2){
+            *d++ = *s++;
+        }
+        dst = reinterpret_cast< uint16_t * >(d);
+        src = reinterpret_cast< const uint16_t * >(s);
+    }
+#endif
+
+    while(n-- > 0){
+        *dst++ = *src++;
+    }
+}
+
+void rgb565_copy_rect(uint16_t * dst, int dst_stride, const uint16_t * src, int src_stride, int w, int h){
+    if(w == dst_stride && w == src_stride){
+        rgb565_copy(dst, src, (size_t) w * h);
+        return;
+    }
+    for(int y = 0; y < h; y++, dst += dst_stride, src += src_stride){
+        rgb565_copy(dst, src, w);
+    }
+}
+
+void rgb565_keyed_copy(uint16_t * dst, const uint16_t * src, size_t n, uint16_t key){
+
+#if defined(ILI9163_RGB565_SSE2)
+    __m128i k = _mm_set1_epi16((short) key);
+    for(; n >= 8; n -= 8, dst += 8, src += 8){
+        __m128i s = _mm_loadu_si128(reinterpret_cast< const __m128i * >(src));
+        __m128i d = _mm_loadu_si128(reinterpret_cast< const __m128i * >(dst));
+        __m128i transparent = _mm_cmpeq_epi16(s, k);
+        d = _mm_or_si128(_mm_and_si128(transparent, d), _mm_andnot_si128(transparent, s));
+        _mm_storeu_si128(reinterpret_cast< __m128i * >(dst), d);
+    }
+#elif defined(ILI9163_RGB565_NEON)
+    uint16x8_t k = vdupq_n_u16(key);
+    for(; n >= 8; n -= 8, dst += 8, src += 8){
+        uint16x8_t s = vld1q_u16(src);
+        vst1q_u16(dst, vbslq_u16(vceqq_u16(s, k), vld1q_u16(dst), s));
+    }
+#else
+    if(aligned(dst) == aligned(src)){
+        if(n > 0 && !aligned(dst)){
+            if(*src != key){
+                *dst = *src;
+            }
+            dst++; src++; n--;
+        }
+        // a fully transparent or fully opaque pair is handled as one word
+        uint32_t key_pair = key | ((uint32_t) key << 16);
+        rgb565_pair * d = reinterpret_cast< rgb565_pair * >(dst);
+        const rgb565_pair * s = reinterpret_cast< const rgb565_pair * >(src);
+        for(; n >= 2; n -= 2, d++, s++){
+            uint32_t p = *s;
+            uint32_t same = p ^ key_pair;
+            if(same == 0){
+                continue;
+            }
+            if((same & 0xffff) != 0 && (same >> 16) != 0){
+                *d = p;
+            } else if((same & 0xffff) != 0){
+                *d = (*d & 0xffff0000) | (p & 0xffff);
+            } else{
+                *d = (*d & 0x0000ffff) | (p & 0xffff0000);
+            }
+        }
+        dst = reinterpret_cast< uint16_t * >(d);
+        src = reinterpret_cast< const uint16_t * >(s);
+    }
+#endif
+
+    for(; n > 0; n--, dst++, src++){
+        if(*src != key){
+            *dst = *src;
+        }
+    }
+}
+
+void rgb565_blend50(uint16_t * dst, const uint16_t * src, size_t n){
+
+    // (a + b) / 2 per field, without carries between the fields:
+    // (a & b) + (((a ^ b) & ~lowbits) >> 1)
+
+#if defined(ILI9163_RGB565_SSE2)
+    __m128i m = _mm_set1_epi16((short) (half_mask & 0xffff));
+    for(; n >= 8; n -= 8, dst += 8, src += 8){
+        __m128i a = _mm_loadu_si128(reinterpret_cast< const __m128i * >(dst));
+        __m128i b = _mm_loadu_si128(reinterpret_cast< const __m128i * >(src));
+        __m128i r = _mm_add_epi16(_mm_and_si128(a, b), _mm_srli_epi16(_mm_and_si128(_mm_xor_si128(a, b), m), 1));
+        _mm_storeu_si128(reinterpret_cast< __m128i * >(dst), r);
+    }
+#elif defined(ILI9163_RGB565_NEON)
+    uint16x8_t m = vdupq_n_u16(half_mask & 0xffff);
+    for(; n >= 8; n -= 8, dst += 8, src += 8){
+        uint16x8_t a = vld1q_u16(dst);
+        uint16x8_t b = vld1q_u16(src);
+        vst1q_u16(dst, vaddq_u16(vandq_u16(a, b), vshrq_n_u16(vandq_u16(veorq_u16(a, b), m), 1)));
+    }
+#else
+    if(aligned(dst) == aligned(src)){
+        if(n > 0 && !aligned(dst)){
+            *dst = (*dst & *src) + (((*dst ^ *src) & half_mask & 0xffff) >> 1);
+            dst++; src++; n--;
+        }
+        rgb565_pair * d = reinterpret_cast< rgb565_pair * >(dst);
+        const rgb565_pair * s = reinterpret_cast< const rgb565_pair * >(src);
+        for(; n >= 2; n -= 2, d++, s++){
+            uint32_t a = *d;
+            uint32_t b = *s;
+            *d = (a & b) + (((a ^ b) & half_mask) >> 1);
+        }
+        dst = reinterpret_cast< uint16_t * >(d);
+        src = reinterpret_cast< const uint16_t * >(s);
+    }
+#endif
+
+    for(; n > 0; n--, dst++, src++){
+        *dst = (*dst & *src) + (((*dst ^ *src) & half_mask & 0xffff) >> 1);
+    }
+}
+
+void rgb565_blend(uint16_t * dst, const uint16_t * src, size_t n, uint8_t alpha){
+    uint32_t a = (alpha + 4) >> 3;
+    if(a == 0){
+        return;
+    }
+    if(a == 32){
+        rgb565_copy(dst, src, n);
+        return;
+    }
+    if(a == 16){
+        rgb565_blend50(dst, src, n);
+        return;
+    }
+
+    // all three fields are mixed with one multiply
+    for(; n > 0; n--, dst++, src++){
+        uint32_t d = spread(*dst);
+        uint32_t s = spread(*src);
+        *dst = unspread((((s - d) * a) >> 5) + d);
+    }
+}
+
+// the fields of a ramp from from to to over n pixels, each field exactly
+// rounded to the nearest level with halves rounded up: pixel i has level
+// from + floor((2 * (to - from) * i + (n - 1)) / (2 * (n - 1))), kept as a
+// level and a remainder in steps of 1 / (2 * (n - 1))
+struct rgb565_ramp {
+    int32_t level[3];
+    int32_t rest[3];
+    int32_t level_step[3];
+    int32_t rest_step[3];
+    int32_t whole;
+
+    rgb565_ramp(uint16_t from, uint16_t to, int n){
+        int32_t f[3] = { (from >> 11) & 0x1f, (from >> 5) & 0x3f, from & 0x1f };
+        int32_t t[3] = { (to >> 11) & 0x1f, (to >> 5) & 0x3f, to & 0x1f };
+        int32_t den = n > 1 ? n - 1 : 1;
+        whole = 2 * den;
+        for(int i = 0; i < 3; i++){
+            int32_t delta = n > 1 ? 2 * (t[i] - f[i]) : 0;
+            // floor division, so the rest of a step is never negative
+            level_step[i] = delta >= 0 ? delta / whole : -((whole - 1 - delta) / whole);
+            rest_step[i] = delta - level_step[i] * whole;
+            level[i] = f[i];
+            rest[i] = den;
+            if(rest[i] >= whole){
+                rest[i] -= whole;
+                level[i]++;
+            }
+        }
+    }
+
+    uint16_t next(){
+        uint16_t p = (level[0] << 11) | (level[1] << 5) | level[2];
+        for(int i = 0; i < 3; i++){
+            level[i] += level_step[i];
+            rest[i] += rest_step[i];
+            if(rest[i] >= whole){
+                rest[i] -= whole;
+                level[i]++;
+            }
+        }
+        return p;
+    }
+};
+
+void rgb565_gradient_h(uint16_t * dst, int stride, int w, int h, uint16_t from, uint16_t to){
+    if(w <= 0 || h <= 0){
+        return;
+    }
+    rgb565_ramp ramp(from, to, w);
+    for(int x = 0; x < w; x++){
+        dst[x] = ramp.next();
+    }
+    // every other row is a copy of the first one
+    for(int y = 1; y < h; y++){
+        rgb565_copy(dst + y * stride, dst, w);
+    }
+}
+
+void rgb565_gradient_v(uint16_t * dst, int stride, int w, int h, uint16_t from, uint16_t to){
+    if(w <= 0 || h <= 0){
+        return;
+    }
+    rgb565_ramp ramp(from, to, h);
+    for(int y = 0; y < h; y++, dst += stride){
+        rgb565_fill(dst, w, ramp.next());
+    }
+}
+
+//========================================================================================================
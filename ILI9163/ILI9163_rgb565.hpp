@@ -0,0 +1,65 @@
+// ==========================================================================
+//
+// Author    : Mohammad Hawari
+// File      : ILI9163_rgb565.hpp
+// Part of   : ILI9163 library for controlling a ILI9163 LCD display
+// Copyright : Mohammad Hawari 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// ==========================================================================
+
+#ifndef ILI9163_RGB565_HPP
+#define ILI9163_RGB565_HPP
+
+#include "hwlib.hpp"
+
+///@file
+
+/// \brief
+/// 16 bit pixel kernels
+/// \details
+/// These functions work on buffers of 16 bit (5,6,5) pixels as used by the display.
+/// They process two pixels per 32 bit word, or eight per SSE2 / NEON register
+/// on host builds that have them. Define ILI9163_RGB565_WORDS to use the
+/// 32 bit word kernels of the Due on every build.
+/// Strides are in pixels.
+
+/// convert a hwlib color to the 16 bit format of the display
+inline uint16_t rgb565_from_color(hwlib::color col){
+    return
+        ( ( static_cast< uint_fast16_t >(col.blue)   & 0x00f8 ) << 8)
+        + ( ( static_cast< uint_fast16_t >(col.green) & 0x00fc ) << 3 )
+        + ( ( static_cast< uint_fast16_t >(col.red)  & 0x00f8 ) >> 3 );
+}
+
+/// fill n pixels with colour
+void rgb565_fill(uint16_t * dst, size_t n, uint16_t colour);
+
+/// fill a w x h rectangle with colour
+void rgb565_fill_rect(uint16_t * dst, int stride, int w, int h, uint16_t colour);
+
+/// copy n pixels
+void rgb565_copy(uint16_t * dst, const uint16_t * src, size_t n);
+
+/// copy a w x h rectangle
+void rgb565_copy_rect(uint16_t * dst, int dst_stride, const uint16_t * src, int src_stride, int w, int h);
+
+/// copy n pixels, except the ones that are equal to key
+void rgb565_keyed_copy(uint16_t * dst, const uint16_t * src, size_t n, uint16_t key);
+
+/// replace n pixels by the 50% mix of themselves and src
+void rgb565_blend50(uint16_t * dst, const uint16_t * src, size_t n);
+
+/// replace n pixels by dst * (255 - alpha) / 255 + src * alpha / 255 (in 1/32 steps)
+void rgb565_blend(uint16_t * dst, const uint16_t * src, size_t n, uint8_t alpha);
+
+/// fill a w x h rectangle with a gradient from left to right
+void rgb565_gradient_h(uint16_t * dst, int stride, int w, int h, uint16_t from, uint16_t to);
+
+/// fill a w x h rectangle with a gradient from top to bottom
+void rgb565_gradient_v(uint16_t * dst, int stride, int w, int h, uint16_t from, uint16_t to);
+
+#endif //ILI9163_RGB565_HPP
@@ -0,0 +1,273 @@
+// ==========================================================================
+//
+// Author    : Mohammad Hawari
+// File      : ILI9163_rle.cpp
+// Part of   : ILI9163 library for controlling a ILI9163 LCD display
+// Copyright : Mohammad Hawari 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// ==========================================================================
+
+#include "ILI9163_rle.hpp"
+#include "ILI9163_rgb565.hpp"
+
+///@file
+
+/// ILI9163_spi_128x128_rle_res_wrx_cs constructor
+///
+/// construct by providing the spi channel, storage for 129 * runs_per_row runs
+/// and for raw_rows * 130 pixels, and initialize the display
+ILI9163_spi_128x128_rle_res_wrx_cs::ILI9163_spi_128x128_rle_res_wrx_cs(hwlib::spi_bus & bus,
+                                                                       ILI9163_pin_out & res,
+                                                                       ILI9163_pin_out & wrx,
+                                                                       ILI9163_pin_out & cs,
+                                                                       ILI9163_rle_run * runs,
+                                                                       uint8_t runs_per_row,
+                                                                       uint16_t * raw,
+                                                                       uint8_t raw_rows):
+
+    ILI9163_spi_res_wrx_cs(bus, res, wrx, cs),
+    window( wsize, hwlib::black, hwlib::white ),
+    runs( runs ),
+    raw( raw ),
+    runs_per_row( runs_per_row == 0 ? 1 : runs_per_row ),
+    raw_rows( raw_rows ),
+    raw_used( 0 )
+{
+    reset(rgb565_from_color(hwlib::white));
+    initialise();
+}
+
+/// ILI9163_spi_128x128_rle_res_wrx_cs constructor
+///
+/// construct with a bus that sends the fills itself, the runs are sent with it
+ILI9163_spi_128x128_rle_res_wrx_cs::ILI9163_spi_128x128_rle_res_wrx_cs(ILI9163_fill_spi_bus & bus,
+                                                                       ILI9163_pin_out & res,
+                                                                       ILI9163_pin_out & wrx,
+                                                                       ILI9163_pin_out & cs,
+                                                                       ILI9163_rle_run * runs,
+                                                                       uint8_t runs_per_row,
+                                                                       uint16_t * raw,
+                                                                       uint8_t raw_rows):
+    ILI9163_spi_128x128_rle_res_wrx_cs(static_cast< hwlib::spi_bus & >( bus ), res, wrx, cs,
+                                       runs, runs_per_row, raw, raw_rows)
+{
+    fill_bus = &bus;
+}
+
+/// every row one run of colour
+void ILI9163_spi_128x128_rle_res_wrx_cs::reset(uint16_t colour){
+    for(int y = 0; y < wsize.y; y++){
+        runs[y * runs_per_row] = ILI9163_rle_run{ colour, (uint8_t) wsize.x };
+        run_count[y] = 1;
+        raw_slot[y] = no_raw;
+    }
+    raw_used = 0;
+}
+
+/// make room for n runs at index in row y
+void ILI9163_spi_128x128_rle_res_wrx_cs::insert(int y, int index, int n){
+    ILI9163_rle_run * row = runs + y * runs_per_row;
+    for(int i = run_count[y] - 1; i >= index; i--){
+        row[i + n] = row[i];
+    }
+    run_count[y] += n;
+}
+
+/// remove n runs at index in row y
+void ILI9163_spi_128x128_rle_res_wrx_cs::remove(int y, int index, int n){
+    ILI9163_rle_run * row = runs + y * runs_per_row;
+    for(int i = index + n; i < run_count[y]; i++){
+        row[i - n] = row[i];
+    }
+    run_count[y] -= n;
+}
+
+/// change pixel x of run-length row y, false when the row needs more runs than it has
+bool ILI9163_spi_128x128_rle_res_wrx_cs::write_run(int y, int x, uint16_t colour){
+    ILI9163_rle_run * row = runs + y * runs_per_row;
+
+    // find the run that holds x
+    int i = 0;
+    int start = 0;
+    while(start + row[i].length <= x){
+        start += row[i].length;
+        i++;
+    }
+    if(row[i].colour == colour){
+        return true;
+    }
+
+    bool first = x == start;
+    bool last = x == start + row[i].length - 1;
+    bool join_left = first && i > 0 && row[i - 1].colour == colour;
+    bool join_right = last && i + 1 < run_count[y] && row[i + 1].colour == colour;
+
+    if(first && last){
+        // a run of one pixel changes colour, and may join its neighbours
+        row[i].colour = colour;
+        if(join_right){
+            row[i].length += row[i + 1].length;
+            remove(y, i + 1, 1);
+        }
+        if(join_left){
+            row[i - 1].length += row[i].length;
+            remove(y, i, 1);
+        }
+        return true;
+    }
+    if(join_left){
+        row[i - 1].length++;
+        row[i].length--;
+        return true;
+    }
+    if(join_right){
+        row[i + 1].length++;
+        row[i].length--;
+        return true;
+    }
+    if(first || last){
+        if(run_count[y] + 1 > runs_per_row){
+            return false;
+        }
+        insert(y, first ? i : i + 1, 1);
+        if(first){
+            row[i] = ILI9163_rle_run{ colour, 1 };
+            row[i + 1].length--;
+        } else{
+            row[i].length--;
+            row[i + 1] = ILI9163_rle_run{ colour, 1 };
+        }
+        return true;
+    }
+
+    // split the run in three
+    if(run_count[y] + 2 > runs_per_row){
+        return false;
+    }
+    int before = x - start;
+    int after = row[i].length - before - 1;
+    insert(y, i + 1, 2);
+    row[i].length = before;
+    row[i + 1] = ILI9163_rle_run{ colour, 1 };
+    row[i + 2] = ILI9163_rle_run{ row[i].colour, (uint8_t) after };
+    return true;
+}
+
+void ILI9163_spi_128x128_rle_res_wrx_cs::write_implementation(hwlib::xy pos, hwlib::color col){
+    uint16_t colour = rgb565_from_color(col);
+    int y = pos.y;
+
+    if(raw_slot[y] != no_raw){
+        raw[raw_slot[y] * wsize.x + pos.x] = colour;
+        return;
+    }
+    if(run_count[y] == 0){
+        // the row lives in the display only
+        pixels_byte_write(pos, colour);
+        return;
+    }
+    if(write_run(y, pos.x, colour)){
+        return;
+    }
+
+    // too many runs: decode the row into a raw row, or send it to the display
+    if(raw_used < raw_rows){
+        uint16_t * p = raw + raw_used * wsize.x;
+        const ILI9163_rle_run * row = runs + y * runs_per_row;
+        for(int i = 0; i < run_count[y]; i++){
+            rgb565_fill(p, row[i].length, row[i].colour);
+            p += row[i].length;
+        }
+        raw_slot[y] = raw_used++;
+        run_count[y] = 0;
+        raw[raw_slot[y] * wsize.x + pos.x] = colour;
+    } else{
+        const ILI9163_rle_run * row = runs + y * runs_per_row;
+        setAddress(0, y, wsize.x - 1, y);
+        for(int i = 0; i < run_count[y]; i++){
+            fill(row[i].colour, row[i].length);
+        }
+        run_count[y] = 0;
+        pixels_byte_write(pos, colour);
+    }
+}
+
+void ILI9163_spi_128x128_rle_res_wrx_cs::clear_implementation( hwlib::color col ){
+    reset(rgb565_from_color(col));
+}
+
+//========================================================================================================
+
+/// write the runs to the display
+void ILI9163_spi_128x128_rle_res_wrx_cs::flush(){
+    uint16_t pending[wsize.x];
+    int n = 0;
+    bool window = false;
+
+    for(int y = 0; y < wsize.y; y++){
+        if(raw_slot[y] == no_raw && run_count[y] == 0){
+            // written directly, skip it and start a new window after it
+            window = false;
+            continue;
+        }
+        if(!window){
+            setAddress(0, y, wsize.x - 1, wsize.y - 1);
+            window = true;
+        }
+        if(raw_slot[y] != no_raw){
+            pixels(raw + raw_slot[y] * wsize.x, wsize.x);
+            continue;
+        }
+
+        // short runs are collected into one burst, long runs are filled
+        const ILI9163_rle_run * row = runs + y * runs_per_row;
+        for(int i = 0; i < run_count[y]; i++){
+            if(row[i].length >= min_fill){
+                if(n > 0){
+                    pixels(pending, n);
+                    n = 0;
+                }
+                fill(row[i].colour, row[i].length);
+            } else{
+                rgb565_fill(pending + n, row[i].length, row[i].colour);
+                n += row[i].length;
+            }
+        }
+        if(n > 0){
+            pixels(pending, n);
+            n = 0;
+        }
+    }
+}
+
+size_t ILI9163_spi_128x128_rle_res_wrx_cs::memory_used() const {
+    size_t used = 0;
+    for(int y = 0; y < wsize.y; y++){
+        used += run_count[y] * sizeof(ILI9163_rle_run);
+    }
+    return used + raw_used * wsize.x * sizeof(uint16_t);
+}
+
+size_t ILI9163_spi_128x128_rle_res_wrx_cs::memory_reserved() const {
+    return wsize.y * runs_per_row * sizeof(ILI9163_rle_run) + raw_rows * wsize.x * sizeof(uint16_t);
+}
+
+uint_fast16_t ILI9163_spi_128x128_rle_res_wrx_cs::raw_row_count() const {
+    return raw_used;
+}
+
+uint_fast16_t ILI9163_spi_128x128_rle_res_wrx_cs::direct_row_count() const {
+    uint_fast16_t n = 0;
+    for(int y = 0; y < wsize.y; y++){
+        if(raw_slot[y] == no_raw && run_count[y] == 0){
+            n++;
+        }
+    }
+    return n;
+}
+
+//========================================================================================================
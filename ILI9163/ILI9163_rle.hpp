@@ -0,0 +1,117 @@
+// ==========================================================================
+//
+// Author    : Mohammad Hawari
+// File      : ILI9163_rle.hpp
+// Part of   : ILI9163 library for controlling a ILI9163 LCD display
+// Copyright : Mohammad Hawari 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// ==========================================================================
+
+#ifndef ILI9163_RLE_HPP
+#define ILI9163_RLE_HPP
+
+#include "hwlib.hpp"
+#include "ILI9163.hpp"
+
+///@file
+
+/// a run of pixels with the same colour
+struct ILI9163_rle_run {
+    uint16_t colour;
+    uint8_t length;
+};
+
+/// \brief
+/// run-length buffered ILI9163 window
+/// \details
+/// Like the buffered window, but each row is stored as at most
+/// runs_per_row runs of one colour, which suits screens that are mostly
+/// large flat areas. A row that needs more runs is stored as a raw row,
+/// taken from a pool of raw_rows rows. When the pool is used up
+/// writes to a fragmented row go directly to the display instead
+/// (the row is then left out of flush until the next clear).
+/// So the memory use is fixed by the storage given to the constructor:
+/// 129 * runs_per_row runs and raw_rows * 130 pixels.
+///
+/// flush() sends long runs with the fill (repeat) path
+/// and collects short runs and raw rows into pixel bursts.
+class ILI9163_spi_128x128_rle_res_wrx_cs : public ILI9163_spi_res_wrx_cs, public hwlib::window {
+
+private:
+
+    static auto constexpr wsize = hwlib::xy(130, 129);
+
+    // runs shorter than this are sent as pixels instead of a fill
+    static constexpr int min_fill = 16;
+
+    ILI9163_rle_run * runs;
+    uint16_t * raw;
+    uint8_t runs_per_row;
+    uint8_t raw_rows;
+    uint8_t raw_used;
+
+    // per row: the number of runs (0 when not run-length)
+    // and the raw row (no_raw when not raw)
+    static constexpr uint8_t no_raw = 0xff;
+    uint8_t run_count[wsize.y];
+    uint8_t raw_slot[wsize.y];
+
+    void write_implementation(hwlib::xy pos, hwlib::color col) override;
+    void clear_implementation( hwlib::color col ) override;
+
+    void reset(uint16_t colour);
+    bool write_run(int y, int x, uint16_t colour);
+    void insert(int y, int index, int n);
+    void remove(int y, int index, int n);
+
+public:
+
+    ILI9163_spi_128x128_rle_res_wrx_cs(hwlib::spi_bus & bus, ILI9163_pin_out & res,
+                                       ILI9163_pin_out & wrx, ILI9163_pin_out & cs,
+                                       ILI9163_rle_run * runs, uint8_t runs_per_row,
+                                       uint16_t * raw, uint8_t raw_rows);
+    ILI9163_spi_128x128_rle_res_wrx_cs(ILI9163_fill_spi_bus & bus, ILI9163_pin_out & res,
+                                       ILI9163_pin_out & wrx, ILI9163_pin_out & cs,
+                                       ILI9163_rle_run * runs, uint8_t runs_per_row,
+                                       uint16_t * raw, uint8_t raw_rows);
+    void flush() override;
+
+    /// bytes of run and raw row storage in use now
+    size_t memory_used() const;
+
+    /// bytes of run and raw row storage given to the constructor
+    size_t memory_reserved() const;
+
+    /// rows stored as raw rows, and rows that were written directly
+    uint_fast16_t raw_row_count() const;
+    uint_fast16_t direct_row_count() const;
+};
+
+/// storage of ILI9163_spi_128x128_rle_storage_res_wrx_cs, a base so it is
+/// constructed before the window resets the runs in it
+template< uint8_t RUNS, uint8_t RAW_ROWS >
+struct ILI9163_rle_storage {
+    ILI9163_rle_run run_storage[129 * RUNS];
+    uint16_t raw_storage[RAW_ROWS * 130 + 1];
+};
+
+/// run-length buffered window that holds its own storage
+template< uint8_t RUNS, uint8_t RAW_ROWS >
+class ILI9163_spi_128x128_rle_storage_res_wrx_cs : private ILI9163_rle_storage< RUNS, RAW_ROWS >, public ILI9163_spi_128x128_rle_res_wrx_cs {
+    static_assert( RUNS >= 1 && RAW_ROWS < 0xff, "RUNS must be at least 1 and RAW_ROWS below 255" );
+
+public:
+    // BUS is hwlib::spi_bus or an ILI9163_fill_spi_bus
+    template< typename BUS >
+    ILI9163_spi_128x128_rle_storage_res_wrx_cs(BUS & bus, ILI9163_pin_out & res,
+                                               ILI9163_pin_out & wrx, ILI9163_pin_out & cs):
+        ILI9163_spi_128x128_rle_res_wrx_cs(bus, res, wrx, cs,
+                                           this->run_storage, RUNS, this->raw_storage, RAW_ROWS)
+    {}
+};
+
+#endif //ILI9163_RLE_HPP
@@ -0,0 +1,261 @@
+// ==========================================================================
+//
+// Author    : Mohammad Hawari
+// File      : ILI9163_simulator.cpp
+// Part of   : ILI9163 library for controlling a ILI9163 LCD display
+// Copyright : Mohammad Hawari 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// ==========================================================================
+
+#include "ILI9163_simulator.hpp"
+
+///@file
+
+/// ILI9163_simulator constructor
+///
+/// construct a controller after reset: sleeping, display off, black memory,
+/// the reset frame rate (DIVA 14, VPA 20) and a partial area of all rows
+ILI9163_simulator::ILI9163_simulator():
+    current( 0 ),
+    argument_count( 0 ),
+    high( 0 ),
+    have_high( false ),
+    read_index( 0 ),
+    window_start( 0, 0 ),
+    window_end( gram_size.x - 1, gram_size.y - 1 ),
+    cursor( 0, 0 ),
+    sleeping( true ),
+    display_on( false ),
+    inverted( false ),
+    idle( false ),
+    partial( false ),
+    diva( 0x0e ),
+    vpa( 0x14 ),
+    partial_first( 0 ),
+    partial_last( gram_size.y - 1 )
+{
+    for(int y = 0; y < gram_size.y; y++){
+        for(int x = 0; x < gram_size.x; x++){
+            gram[y][x] = 0;
+        }
+    }
+    for(auto & entry : colour_lut){
+        entry = 0;
+    }
+}
+
+void ILI9163_simulator::command(uint8_t c){
+    current = c;
+    argument_count = 0;
+    have_high = false;
+    read_index = 0;
+
+    switch((ILI9163_commands) c){
+        case ILI9163_commands::enter_sleep_mode:    sleeping = true;    break;
+        case ILI9163_commands::exit_sleep_mode:     sleeping = false;   break;
+        case ILI9163_commands::enter_partial_mode:  partial = true;     break;
+        case ILI9163_commands::enter_normal_mode:   partial = false;    break;
+        case ILI9163_commands::exit_invert_mode:    inverted = false;   break;
+        case ILI9163_commands::enter_invert_mode:   inverted = true;    break;
+        case ILI9163_commands::set_display_off:     display_on = false; break;
+        case ILI9163_commands::set_display_on:      display_on = true;  break;
+        case ILI9163_commands::exit_idle_mode:      idle = false;       break;
+        case ILI9163_commands::enter_idle_mode:     idle = true;        break;
+        case ILI9163_commands::write_memory_start:
+        case ILI9163_commands::read_memory_start:
+            cursor = window_start;
+            break;
+        default:
+            break;
+    }
+}
+
+void ILI9163_simulator::data(uint8_t d){
+    switch((ILI9163_commands) current){
+
+        case ILI9163_commands::set_column_address:
+        case ILI9163_commands::set_page_address:
+            if(argument_count < 4){
+                arguments[argument_count++] = d;
+            }
+            if(argument_count == 4){
+                int first = arguments[0] << 8 | arguments[1];
+                int last = arguments[2] << 8 | arguments[3];
+                if(current == static_cast< uint8_t >( ILI9163_commands::set_column_address )){
+                    window_start.x = first;
+                    window_end.x = last;
+                } else{
+                    window_start.y = first;
+                    window_end.y = last;
+                }
+            }
+            break;
+
+        case ILI9163_commands::write_memory_start:
+        case ILI9163_commands::write_memory_continue:
+            if(!have_high){
+                high = d;
+                have_high = true;
+            } else{
+                have_high = false;
+                pixel_write(high << 8 | d);
+            }
+            break;
+
+        case ILI9163_commands::set_partial_area:
+            if(argument_count < 4){
+                arguments[argument_count++] = d;
+            }
+            if(argument_count == 4){
+                partial_first = arguments[0] << 8 | arguments[1];
+                partial_last = arguments[2] << 8 | arguments[3];
+            }
+            break;
+
+        case ILI9163_commands::FRAME_RATE_CONTROL1:
+            if(argument_count == 0){
+                diva = d;
+            } else if(argument_count == 1){
+                vpa = d;
+            }
+            argument_count++;
+            break;
+
+        case ILI9163_commands::write_LUT:
+            if(argument_count < sizeof(colour_lut)){
+                colour_lut[argument_count++] = d;
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+uint8_t ILI9163_simulator::read(){
+    if(current != static_cast< uint8_t >( ILI9163_commands::read_memory_start )){
+        return 0;
+    }
+    if(read_index == 0){
+        read_index = 1;
+        return 0;
+    }
+
+    uint16_t p = cursor.x < gram_size.x && cursor.y < gram_size.y ? gram[cursor.y][cursor.x] : 0;
+    int level;
+    switch(read_index){
+        case 1:  level = (p >> 11) << 1 | (p >> 15);          break;
+        case 2:  level = (p >> 5) & 0x3f;                     break;
+        default: level = (p & 0x1f) << 1 | ((p >> 4) & 0x01); break;
+    }
+    if(++read_index == 4){
+        read_index = 1;
+        next_pixel();
+    }
+    return level << 2;
+}
+
+void ILI9163_simulator::pixel_write(uint16_t p){
+    if(cursor.x < gram_size.x && cursor.y < gram_size.y){
+        gram[cursor.y][cursor.x] = p;
+    }
+    next_pixel();
+}
+
+void ILI9163_simulator::next_pixel(){
+    cursor.x++;
+    if(cursor.x > window_end.x){
+        cursor.x = window_start.x;
+        cursor.y++;
+        if(cursor.y > window_end.y){
+            cursor.y = window_start.y;
+        }
+    }
+}
+
+void ILI9163_simulator::replay(const ILI9163_trace_record & r, const uint16_t * pixels){
+    switch(r.kind){
+
+        case ILI9163_trace_kind::command:
+            command(r.byte);
+            break;
+
+        case ILI9163_trace_kind::parameter:
+            data(r.byte);
+            break;
+
+        case ILI9163_trace_kind::data16:
+            data(r.value >> 8);
+            data(r.value & 0xff);
+            break;
+
+        case ILI9163_trace_kind::window: {
+            const uint8_t columns[] = { 0, (uint8_t) (r.count >> 8), 0, (uint8_t) (r.count & 0xff) };
+            const uint8_t pages[] = { 0, (uint8_t) (r.value >> 8), 0, (uint8_t) (r.value & 0xff) };
+            command(static_cast< uint8_t >( ILI9163_commands::set_column_address ));
+            for(auto b : columns){
+                data(b);
+            }
+            command(static_cast< uint8_t >( ILI9163_commands::set_page_address ));
+            for(auto b : pages){
+                data(b);
+            }
+            command(static_cast< uint8_t >( ILI9163_commands::write_memory_start ));
+            break;
+        }
+
+        case ILI9163_trace_kind::bytes:
+            for(int i = 0; i < r.count; i++){
+                data(pixels != nullptr ? pixels[i] & 0xff : r.byte);
+            }
+            break;
+
+        case ILI9163_trace_kind::pixels:
+        case ILI9163_trace_kind::fill:
+            for(int i = 0; i < r.count; i++){
+                pixel_write(pixels != nullptr && r.kind == ILI9163_trace_kind::pixels ? pixels[i] : r.value);
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+void ILI9163_simulator::replay(const ILI9163_trace & trace){
+    for(size_t i = 0; i < trace.size(); i++){
+        const auto & r = trace[i];
+        if(r.kind == ILI9163_trace_kind::pixels && trace.has_pixels(r.data, r.count)){
+            for(int j = 0; j < r.count; j++){
+                pixel_write(trace.pixel(r.data + j));
+            }
+        } else if(r.kind == ILI9163_trace_kind::bytes && trace.has_pixels(r.data, r.count)){
+            for(int j = 0; j < r.count; j++){
+                data(trace.pixel(r.data + j) & 0xff);
+            }
+        } else{
+            replay(r);
+        }
+    }
+}
+
+//========================================================================================================
+
+void ILI9163_simulator_bus::write_and_read(const size_t n, const uint8_t data_out[], uint8_t data_in[]){
+    for(size_t i = 0; i < n; i++){
+        uint8_t d = data_out != nullptr ? data_out[i] : 0;
+        if(dc.level){
+            display.data(d);
+        } else{
+            display.command(d);
+        }
+        if(data_in != nullptr){
+            data_in[i] = dc.level ? display.read() : 0;
+        }
+    }
+    byte_count += n;
+}
@@ -0,0 +1,150 @@
+// ==========================================================================
+//
+// Author    : Mohammad Hawari
+// File      : ILI9163_simulator.hpp
+// Part of   : ILI9163 library for controlling a ILI9163 LCD display
+// Copyright : Mohammad Hawari 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// ==========================================================================
+
+#ifndef ILI9163_SIMULATOR_HPP
+#define ILI9163_SIMULATOR_HPP
+
+#include "hwlib.hpp"
+#include "ILI9163_commands.hpp"
+#include "ILI9163_trace.hpp"
+
+///@file
+
+/// \brief
+/// model of the ILI9163 controller, for the host
+/// \details
+/// Feed it the bytes the driver sends, with command() for bytes sent with
+/// wrx low and data() for bytes sent with wrx high, or replay trace records.
+/// It keeps the 132 x 162 graphics memory (16 bit pixels as written), the
+/// colour LUT, the address window, the power and display modes, the
+/// frame rate setting and the partial area.
+/// After read_memory_start read() answers like the controller: a dummy
+/// byte, then 3 bytes per pixel.
+class ILI9163_simulator {
+public:
+    static auto constexpr gram_size = hwlib::xy(132, 162);
+
+private:
+    uint16_t gram[gram_size.y][gram_size.x];
+    uint8_t colour_lut[128];
+
+    uint8_t current;            // the last command
+    uint8_t arguments[4];
+    size_t argument_count;
+    uint8_t high;               // first byte of a pixel
+    bool have_high;
+    uint8_t read_index;         // 0 before the dummy byte, then 1 .. 3 within a pixel
+
+    hwlib::xy window_start, window_end, cursor;
+
+    void pixel_write(uint16_t p);
+    void next_pixel();
+
+public:
+    /// display modes, as set by the commands
+    bool sleeping, display_on, inverted, idle, partial;
+
+    /// the normal mode frame rate setting (FRAME_RATE_CONTROL1), as last set
+    uint8_t diva, vpa;
+
+    /// the rows of the partial area (set_partial_area), as last set
+    uint16_t partial_first, partial_last;
+
+    ILI9163_simulator();
+
+    /// a byte sent with wrx low
+    void command(uint8_t c);
+
+    /// a byte sent with wrx high
+    void data(uint8_t d);
+
+    /// \brief
+    /// the byte the controller sends back while a data byte is clocked out
+    /// \details
+    /// After read_memory_start the first byte is a dummy, then each pixel
+    /// of the window comes as 3 bytes (high field, green, low field), each
+    /// a 6 bit level in the top bits as the identity LUT gives it.
+    /// Other commands read as 0.
+    uint8_t read();
+
+    /// \brief
+    /// apply a trace record
+    /// \details
+    /// For a pixels record pass its count pixels, when they were not
+    /// captured (nullptr) all pixels of the run get the first colour,
+    /// which is in the record: the windows and fills of a frame are then
+    /// still exact, images only blocks. A bytes record takes its bytes
+    /// from the low byte of each pixel, or repeats its first byte.
+    void replay(const ILI9163_trace_record & r, const uint16_t * pixels = nullptr);
+
+    /// apply all records of a trace, with their captured pixels where the trace has them
+    void replay(const ILI9163_trace & trace);
+
+    /// the pixel in graphics memory at x, y
+    uint16_t pixel(hwlib::xy pos) const {
+        return gram[pos.y][pos.x];
+    }
+
+    /// entry i of the colour LUT (0 .. 31 high field, 32 .. 95 green, 96 .. 127 low field)
+    uint8_t lut(int i) const {
+        return colour_lut[i];
+    }
+};
+
+/// \brief
+/// spi bus with an ILI9163_simulator on the other end, for the host
+/// \details
+/// Give wrx() to the display as its wrx pin: bytes sent while it is low go
+/// to the simulator as commands, the others as data, and reads are answered
+/// by the simulator. The bytes are counted, to compare drawing methods.
+class ILI9163_simulator_bus : public hwlib::spi_bus {
+private:
+
+    // the wrx (data / command) pin, the bus looks at its level
+    class wrx_pin : public hwlib::pin_out {
+    public:
+        bool level = true;
+
+        void write(bool v) override {
+            level = v;
+        }
+    };
+
+    ILI9163_simulator & display;
+    wrx_pin dc;
+    size_t byte_count;
+
+    void write_and_read(const size_t n, const uint8_t data_out[], uint8_t data_in[]) override;
+
+public:
+    ILI9163_simulator_bus(ILI9163_simulator & display):
+        display( display ),
+        byte_count( 0 )
+    {}
+
+    /// the pin to pass as the wrx pin of the display
+    hwlib::pin_out & wrx(){
+        return dc;
+    }
+
+    /// bytes transferred since construction or the last clear_count()
+    size_t bytes() const {
+        return byte_count;
+    }
+
+    void clear_count(){
+        byte_count = 0;
+    }
+};
+
+#endif //ILI9163_SIMULATOR_HPP
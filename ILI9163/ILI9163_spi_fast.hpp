@@ -0,0 +1,151 @@
+// ==========================================================================
+//
+// Author    : Mohammad Hawari
+// File      : ILI9163_spi_fast.hpp
+// Part of   : ILI9163 library for controlling a ILI9163 LCD display
+// Copyright : Mohammad Hawari 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// ==========================================================================
+
+#ifndef ILI9163_SPI_FAST_HPP
+#define ILI9163_SPI_FAST_HPP
+
+#include "hwlib.hpp"
+#include "ILI9163.hpp"
+
+///@file
+
+#ifdef BMPTK_TARGET_arduino_due
+
+/// \brief
+/// SAM3X parallel IO port
+/// \details
+/// Sets and clears pins by writing the set (SODR) and clear (CODR)
+/// output data registers of the port directly.
+/// The pins must already be configured as outputs, eg by constructing
+/// a hwlib::target::pin_out for them.
+///
+/// hold() reads the pin data status register twice. A read of a PIO
+/// register waits for the peripheral bridge, so unlike a nop it can not
+/// be dropped by the core: at 84 MHz the two reads and the store that
+/// follows take at least 5 cycles (60 ns).
+class ILI9163_pio_sam3x {
+private:
+    Pio & port;
+
+public:
+    ILI9163_pio_sam3x(Pio & port):
+        port( port )
+    {}
+
+    void set(uint32_t mask){
+        port.PIO_SODR = mask;
+    }
+
+    void clear(uint32_t mask){
+        port.PIO_CODR = mask;
+    }
+
+    void hold(){
+        (void) port.PIO_PDSR;
+        (void) port.PIO_PDSR;
+    }
+};
+
+#endif
+
+/// \brief
+/// write-only bit banged spi bus on two pins of one port
+/// \details
+/// A faster replacement for hwlib::spi_bus_bit_banged_sclk_mosi_miso
+/// for the ILI9163: the clock and data pins are written through the port
+/// registers instead of virtual pin calls, the byte loop is unrolled,
+/// there are no wait calls and MISO is not sampled (reads return 0).
+/// The clock idles low and data is valid on the rising edge (mode 0).
+///
+/// The ILI9163 serial write timing asks for SCL high and low for at least
+/// 40 ns each, a write cycle of at least 100 ns and data set up 30 ns
+/// before the rising edge. Back to back port stores can be 2 cycles (24 ns)
+/// apart at 84 MHz, so each bit calls PORT::hold() after it sets MOSI and
+/// after the rising edge: the data setup and the low time, and the high
+/// time, are each at least one hold. The cycle is then at least two holds.
+///
+/// PORT needs set(mask), clear(mask) and hold(), on the Due use ILI9163_pio_sam3x.
+/// A host build can use a PORT that records the calls to check the bit sequence.
+/// The bus implements ILI9163_fill_spi_bus, so a display fills through
+/// write_repeated16.
+template< typename PORT >
+class ILI9163_spi_bus_bit_banged_sclk_mosi : public ILI9163_fill_spi_bus {
+private:
+    PORT port;
+    uint32_t sclk;
+    uint32_t mosi;
+
+    void bit(bool b){
+        if(b){
+            port.set(mosi);
+        } else{
+            port.clear(mosi);
+        }
+        port.hold();
+        port.set(sclk);
+        port.hold();
+        port.clear(sclk);
+    }
+
+    void byte(uint8_t d){
+        bit(d & 0x80);
+        bit(d & 0x40);
+        bit(d & 0x20);
+        bit(d & 0x10);
+        bit(d & 0x08);
+        bit(d & 0x04);
+        bit(d & 0x02);
+        bit(d & 0x01);
+    }
+
+    void write_and_read(const size_t n, const uint8_t data_out[], uint8_t data_in[]) override {
+        for(size_t i = 0; i < n; i++){
+            byte(data_out == nullptr ? 0 : data_out[i]);
+            if(data_in != nullptr){
+                data_in[i] = 0;
+            }
+        }
+    }
+
+public:
+    /// construct from the port and the masks of the clock and data pin
+    ILI9163_spi_bus_bit_banged_sclk_mosi(PORT port, uint32_t sclk, uint32_t mosi):
+        port( port ),
+        sclk( sclk ),
+        mosi( mosi )
+    {
+        this->port.clear(sclk);
+    }
+
+    /// \brief
+    /// write a 16 bit value n times as pixel data
+    /// \details
+    /// Sets dc (data) and sends all values in one transaction on sel,
+    /// for filling an address window with one colour.
+    void write_repeated16(hwlib::pin_out & sel, hwlib::pin_out & dc, uint16_t value, size_t n) override {
+        dc.write(1);
+        dc.flush();
+        sel.write(0);
+        sel.flush();
+        uint8_t high = value >> 8;
+        uint8_t low = value & 0xff;
+        while(n-- > 0){
+            byte(high);
+            byte(low);
+        }
+        sel.write(1);
+        sel.flush();
+    }
+};
+
+#endif //ILI9163_SPI_FAST_HPP
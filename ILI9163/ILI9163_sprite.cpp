@@ -0,0 +1,130 @@
+// ==========================================================================
+//
+// Author    : Mohammad Hawari
+// File      : ILI9163_sprite.cpp
+// Part of   : ILI9163 library for controlling a ILI9163 LCD display
+// Copyright : Mohammad Hawari 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// ==========================================================================
+
+#include "ILI9163_sprite.hpp"
+
+///@file
+
+void ILI9163_solid_background::row(hwlib::xy /*start*/, size_t n, uint16_t row[]){
+    for(size_t i = 0; i < n; i++){
+        row[i] = colour;
+    }
+}
+
+void ILI9163_image_background::row(hwlib::xy start, size_t n, uint16_t row[]){
+    const uint16_t * p = pixels + start.x + stride * start.y;
+    for(size_t i = 0; i < n; i++){
+        row[i] = p[i];
+    }
+}
+
+//========================================================================================================
+
+/// ILI9163_sprite_layer constructor
+///
+/// construct by providing the display, the background and an array of sprites
+ILI9163_sprite_layer::ILI9163_sprite_layer(ILI9163_spi_res_wrx_cs & display,
+                                           ILI9163_background & background,
+                                           ILI9163_sprite * const sprites[],
+                                           size_t count):
+    display( display ),
+    background( background ),
+    sprites( sprites ),
+    count( count )
+{}
+
+void ILI9163_sprite_layer::redraw(hwlib::xy start, hwlib::xy end){
+
+    // clip to the display
+    if(start.x < 0){ start.x = 0; }
+    if(start.y < 0){ start.y = 0; }
+    if(end.x > wsize.x){ end.x = wsize.x; }
+    if(end.y > wsize.y){ end.y = wsize.y; }
+    if(start.x >= end.x || start.y >= end.y){
+        return;
+    }
+
+    uint16_t row[wsize.x];
+    int width = end.x - start.x;
+
+    display.setAddress(start.x, start.y, end.x - 1, end.y - 1);
+    for(int y = start.y; y < end.y; y++){
+
+        background.row(hwlib::xy(start.x, y), width, row);
+
+        for(size_t i = 0; i < count; i++){
+            const ILI9163_sprite & s = *sprites[i];
+            const ILI9163_sprite_image & image = *s.image;
+            if(!s.visible || y < s.position.y || y >= s.position.y + image.size.y){
+                continue;
+            }
+            int x0 = s.position.x > start.x ? s.position.x : start.x;
+            int x1 = s.position.x + image.size.x < end.x ? s.position.x + image.size.x : end.x;
+            const uint16_t * p = image.pixels + image.size.x * (y - s.position.y) + (x0 - s.position.x);
+            for(int x = x0; x < x1; x++, p++){
+                if(*p != image.key){
+                    row[x - start.x] = *p;
+                }
+            }
+        }
+
+        display.pixels(row, width);
+    }
+}
+
+void ILI9163_sprite_layer::draw(){
+    redraw(hwlib::xy(0, 0), wsize);
+}
+
+void ILI9163_sprite_layer::move(ILI9163_sprite & sprite, hwlib::xy position){
+    hwlib::xy old_start = sprite.position;
+    hwlib::xy old_end = sprite.position + sprite.image->size;
+    sprite.position = position;
+    hwlib::xy new_start = position;
+    hwlib::xy new_end = position + sprite.image->size;
+
+    if(!sprite.visible){
+        return;
+    }
+
+    bool touching = old_start.x <= new_end.x && new_start.x <= old_end.x
+                 && old_start.y <= new_end.y && new_start.y <= old_end.y;
+    if(touching){
+        // one window covering both areas
+        redraw(hwlib::xy(old_start.x < new_start.x ? old_start.x : new_start.x,
+                         old_start.y < new_start.y ? old_start.y : new_start.y),
+               hwlib::xy(old_end.x > new_end.x ? old_end.x : new_end.x,
+                         old_end.y > new_end.y ? old_end.y : new_end.y));
+    } else{
+        redraw(old_start, old_end);
+        redraw(new_start, new_end);
+    }
+}
+
+void ILI9163_sprite_layer::set_image(ILI9163_sprite & sprite, const ILI9163_sprite_image & image){
+    hwlib::xy old_end = sprite.position + sprite.image->size;
+    sprite.image = &image;
+    hwlib::xy new_end = sprite.position + image.size;
+    redraw(sprite.position,
+           hwlib::xy(old_end.x > new_end.x ? old_end.x : new_end.x,
+                     old_end.y > new_end.y ? old_end.y : new_end.y));
+}
+
+void ILI9163_sprite_layer::show(ILI9163_sprite & sprite, bool visible){
+    if(sprite.visible != visible){
+        sprite.visible = visible;
+        redraw(sprite.position, sprite.position + sprite.image->size);
+    }
+}
+
+//========================================================================================================
@@ -0,0 +1,124 @@
+// ==========================================================================
+//
+// Author    : Mohammad Hawari
+// File      : ILI9163_sprite.hpp
+// Part of   : ILI9163 library for controlling a ILI9163 LCD display
+// Copyright : Mohammad Hawari 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// ==========================================================================
+
+#ifndef ILI9163_SPRITE_HPP
+#define ILI9163_SPRITE_HPP
+
+#include "hwlib.hpp"
+#include "ILI9163.hpp"
+
+///@file
+
+/// \brief
+/// sprite image
+/// \details
+/// The pixels are in the 16 bit format of the display, row by row.
+/// Pixels equal to key are transparent.
+/// Declare the pixel array const so it stays in flash.
+struct ILI9163_sprite_image {
+    hwlib::xy size;
+    uint16_t key;
+    const uint16_t * pixels;
+};
+
+/// \brief
+/// background below the sprites
+/// \details
+/// The background is drawn where a sprite moves away
+/// and below the transparent pixels of a sprite.
+class ILI9163_background {
+public:
+    /// write the background of n pixels starting at start into row
+    virtual void row(hwlib::xy start, size_t n, uint16_t row[]) = 0;
+};
+
+/// single colour background
+class ILI9163_solid_background : public ILI9163_background {
+private:
+    uint16_t colour;
+
+public:
+    ILI9163_solid_background(uint16_t colour):
+        colour( colour )
+    {}
+
+    void row(hwlib::xy start, size_t n, uint16_t row[]) override;
+};
+
+/// full screen image background, eg a logo in flash
+class ILI9163_image_background : public ILI9163_background {
+private:
+    const uint16_t * pixels;
+    int stride;
+
+public:
+    ILI9163_image_background(const uint16_t * pixels, int stride = 130):
+        pixels( pixels ),
+        stride( stride )
+    {}
+
+    void row(hwlib::xy start, size_t n, uint16_t row[]) override;
+};
+
+/// a sprite: an image at a position
+class ILI9163_sprite {
+public:
+    const ILI9163_sprite_image * image;
+    hwlib::xy position;
+    bool visible;
+
+    ILI9163_sprite(const ILI9163_sprite_image & image, hwlib::xy position, bool visible = true):
+        image( &image ),
+        position( position ),
+        visible( visible )
+    {}
+};
+
+/// \brief
+/// sprite engine
+/// \details
+/// Draws a set of sprites over a background directly on the display.
+/// A changed area is drawn as one address window, one row burst at a time:
+/// each row is built from the background and the sprites (in array order,
+/// the last sprite on top) and then sent with a single transaction.
+/// Moving a sprite redraws the old and the new area only.
+class ILI9163_sprite_layer {
+private:
+    static auto constexpr wsize = hwlib::xy(130, 129);
+
+    ILI9163_spi_res_wrx_cs & display;
+    ILI9163_background & background;
+    ILI9163_sprite * const * sprites;
+    size_t count;
+
+public:
+    ILI9163_sprite_layer(ILI9163_spi_res_wrx_cs & display, ILI9163_background & background,
+                         ILI9163_sprite * const sprites[], size_t count);
+
+    /// draw the area from start up to (not including) end
+    void redraw(hwlib::xy start, hwlib::xy end);
+
+    /// draw the background and all sprites
+    void draw();
+
+    /// move a sprite and redraw the areas it left and entered
+    void move(ILI9163_sprite & sprite, hwlib::xy position);
+
+    /// change the image of a sprite and redraw it
+    void set_image(ILI9163_sprite & sprite, const ILI9163_sprite_image & image);
+
+    /// show or hide a sprite
+    void show(ILI9163_sprite & sprite, bool visible);
+};
+
+#endif //ILI9163_SPRITE_HPP
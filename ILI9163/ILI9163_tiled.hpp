@@ -0,0 +1,132 @@
+// ==========================================================================
+//
+// Author    : Mohammad Hawari
+// File      : ILI9163_tiled.hpp
+// Part of   : ILI9163 library for controlling a ILI9163 LCD display
+// Copyright : Mohammad Hawari 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// ==========================================================================
+
+#ifndef ILI9163_TILED_HPP
+#define ILI9163_TILED_HPP
+
+#include <array>
+#include "hwlib.hpp"
+#include "ILI9163.hpp"
+#include "ILI9163_rgb565.hpp"
+
+///@file
+
+/// \brief
+/// one window over a COLUMNS x ROWS grid of panels
+/// \details
+/// The panels are ILI9163 windows of type PANEL (direct or buffered),
+/// each on its own chip select, given in row order (left to right, top
+/// to bottom). All panels must have the same size. The tiled window is
+/// COLUMNS panels wide and ROWS panels high; a pixel is written to the
+/// panel that owns it.
+///
+/// fill_rect and write_rect are clipped to the tiled window and split at
+/// the panel edges, so each panel gets one burst. flush() only flushes
+/// the panels that were written since the previous flush.
+template< typename PANEL, int COLUMNS, int ROWS >
+class ILI9163_tiled_window : public hwlib::window {
+    static_assert( COLUMNS > 0 && ROWS > 0 && COLUMNS * ROWS <= 32, "between 1 and 32 panels" );
+
+private:
+
+    std::array< PANEL *, COLUMNS * ROWS > panels;
+    hwlib::xy panel_size;
+
+    // one bit per panel that was written since the last flush
+    uint32_t dirty;
+
+    PANEL & panel(int column, int row){
+        dirty |= 1u << (row * COLUMNS + column);
+        return *panels[row * COLUMNS + column];
+    }
+
+    void write_implementation(hwlib::xy pos, hwlib::color col) override {
+        int column = pos.x / panel_size.x;
+        int row = pos.y / panel_size.y;
+        panel(column, row).write(pos - hwlib::xy(column * panel_size.x, row * panel_size.y), col);
+    }
+
+    void clear_implementation(hwlib::color col) override {
+        for(auto p : panels){
+            p->clear(col);
+        }
+        dirty = ~0u;
+    }
+
+    // call f(panel, local position, size, offset in the rectangle) for the part
+    // of the rectangle pos, size on every panel it covers, after clipping
+    template< typename F >
+    void split(hwlib::xy pos, hwlib::xy size, F f){
+        int x0 = pos.x < 0 ? 0 : pos.x;
+        int y0 = pos.y < 0 ? 0 : pos.y;
+        int x1 = pos.x + size.x < this->size.x ? pos.x + size.x : this->size.x;
+        int y1 = pos.y + size.y < this->size.y ? pos.y + size.y : this->size.y;
+        if(x0 >= x1 || y0 >= y1){
+            return;
+        }
+
+        for(int row = y0 / panel_size.y; row * panel_size.y < y1; row++){
+            int top = row * panel_size.y;
+            int py0 = y0 > top ? y0 : top;
+            int py1 = y1 < top + panel_size.y ? y1 : top + panel_size.y;
+            for(int column = x0 / panel_size.x; column * panel_size.x < x1; column++){
+                int left = column * panel_size.x;
+                int px0 = x0 > left ? x0 : left;
+                int px1 = x1 < left + panel_size.x ? x1 : left + panel_size.x;
+                f(panel(column, row), hwlib::xy(px0 - left, py0 - top),
+                  hwlib::xy(px1 - px0, py1 - py0), hwlib::xy(px0 - pos.x, py0 - pos.y));
+            }
+        }
+    }
+
+public:
+
+    ILI9163_tiled_window(const std::array< PANEL *, COLUMNS * ROWS > & panels):
+        window( hwlib::xy(COLUMNS * panels[0]->size.x, ROWS * panels[0]->size.y), hwlib::black, hwlib::white ),
+        panels( panels ),
+        panel_size( panels[0]->size ),
+        dirty( 0 )
+    {}
+
+    /// fill a size.x x size.y block at pos with col, one burst per panel
+    void fill_rect(hwlib::xy pos, hwlib::xy size, hwlib::color col){
+        uint16_t colour = rgb565_from_color(col);
+        split(pos, size, [&](PANEL & p, hwlib::xy at, hwlib::xy part, hwlib::xy){
+            p.fill_rect(at, part, colour);
+        });
+    }
+
+    /// copy a size.x x size.y block of pixels to pos, one burst per panel
+    void write_rect(hwlib::xy pos, hwlib::xy size, const uint16_t * src, int stride){
+        split(pos, size, [&](PANEL & p, hwlib::xy at, hwlib::xy part, hwlib::xy from){
+            p.write_rect(at, part, src + from.x + stride * from.y, stride);
+        });
+    }
+
+    /// flush the panels that were written since the previous flush
+    void flush() override {
+        for(int i = 0; i < COLUMNS * ROWS; i++){
+            if(dirty & (1u << i)){
+                panels[i]->flush();
+            }
+        }
+        dirty = 0;
+    }
+
+    /// the panel in column, row
+    PANEL & operator()(int column, int row){
+        return panel(column, row);
+    }
+};
+
+#endif //ILI9163_TILED_HPP
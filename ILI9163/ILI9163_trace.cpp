@@ -0,0 +1,86 @@
+// ==========================================================================
+//
+// Author    : Mohammad Hawari
+// File      : ILI9163_trace.cpp
+// Part of   : ILI9163 library for controlling a ILI9163 LCD display
+// Copyright : Mohammad Hawari 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// ==========================================================================
+
+#include "ILI9163_trace.hpp"
+
+///@file
+
+/// ILI9163_trace constructor
+///
+/// construct by providing storage for capacity records,
+/// and optionally for pixel_capacity pixels of pixel data
+ILI9163_trace::ILI9163_trace(ILI9163_trace_record * records, size_t capacity,
+                             uint16_t * pixel_data, size_t pixel_capacity):
+    records( records ),
+    capacity( capacity ),
+    next( 0 ),
+    used( 0 ),
+    lost( 0 ),
+    pixel_data( pixel_data ),
+    pixel_capacity( pixel_data != nullptr ? pixel_capacity : 0 ),
+    pixel_count( 0 )
+{}
+
+void ILI9163_trace::clear(){
+    next = 0;
+    used = 0;
+    lost = 0;
+    pixel_count = 0;
+}
+
+bool ILI9163_trace::has_pixels(uint32_t position, size_t n) const {
+    uint32_t oldest = pixel_count > pixel_capacity ? pixel_count - pixel_capacity : 0;
+    return pixel_capacity > 0 && position >= oldest && position + n <= pixel_count;
+}
+
+/// \brief
+/// write the records as text
+/// \details
+/// The format is
+///
+///     ILI9163 trace begin
+///     ticks_per_us <n>
+///     records <n>
+///     lost <n>
+///     <start> <end> <kind> <byte> <count> <value> <data>  (one line per record)
+///     pixel_data <position> <n>
+///     <pixel> ...                                         (16 per line)
+///     ILI9163 trace end
+///
+/// with the pixels in hexadecimal and all other numbers in decimal,
+/// so the dump can be cut from a serial log.
+/// The pixel data holds the n pixels from position on that are still in the ring.
+void ILI9163_trace::dump(hwlib::ostream & out) const {
+    out << "ILI9163 trace begin\n";
+    out << "ticks_per_us " << (unsigned int) hwlib::ticks_per_us() << "\n";
+    out << "records " << (unsigned int) used << "\n";
+    out << "lost " << (unsigned int) lost << "\n";
+    for(size_t i = 0; i < used; i++){
+        const auto & r = (*this)[i];
+        out << (unsigned int) r.start << " " << (unsigned int) r.end << " "
+            << (unsigned int) r.kind << " " << (unsigned int) r.byte << " "
+            << (unsigned int) r.count << " " << (unsigned int) r.value << " "
+            << (unsigned int) r.data << "\n";
+    }
+
+    uint32_t first = pixel_count > pixel_capacity ? pixel_count - pixel_capacity : 0;
+    uint32_t n = pixel_capacity > 0 ? pixel_count - first : 0;
+    out << "pixel_data " << (unsigned int) first << " " << (unsigned int) n << "\n";
+    static const char digits[] = "0123456789abcdef";
+    for(uint32_t i = 0; i < n; i++){
+        uint16_t p = pixel_data[(first + i) % pixel_capacity];
+        out << digits[p >> 12] << digits[(p >> 8) & 0x0f] << digits[(p >> 4) & 0x0f] << digits[p & 0x0f];
+        out << ((i % 16 == 15 || i + 1 == n) ? '\n' : ' ');
+    }
+    out << "ILI9163 trace end" << hwlib::endl;
+}
@@ -0,0 +1,172 @@
+// ==========================================================================
+//
+// Author    : Mohammad Hawari
+// File      : ILI9163_trace.hpp
+// Part of   : ILI9163 library for controlling a ILI9163 LCD display
+// Copyright : Mohammad Hawari 2021.
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// ==========================================================================
+
+#ifndef ILI9163_TRACE_HPP
+#define ILI9163_TRACE_HPP
+
+#include "hwlib.hpp"
+
+///@file
+
+/// what a trace record describes
+enum class ILI9163_trace_kind : uint8_t {
+    command     = 1,    ///< byte: the command
+    parameter   = 2,    ///< byte: the parameter or data byte
+    data16      = 3,    ///< value: the 16 bit data
+    window      = 4,    ///< address window and memory write, count: x1 << 8 | x2, value: y1 << 8 | y2
+    pixels      = 5,    ///< count: number of pixels, value: the first pixel, data: position in the pixel data
+    fill        = 6,    ///< count: number of pixels, value: the colour
+    read        = 7,    ///< count: number of pixels read back
+    list        = 8,    ///< count: bytes of a replayed display list, its transfers follow as records
+    bytes       = 9     ///< count: number of data bytes, byte: the first byte, data: position in the pixel data
+};
+
+/// one traced transfer, with the tick counter at its start and end
+struct ILI9163_trace_record {
+    uint32_t start;
+    uint32_t end;
+    uint32_t data;
+    uint16_t count;
+    uint16_t value;
+    ILI9163_trace_kind kind;
+    uint8_t byte;
+};
+
+/// \brief
+/// capture of the traffic to a display
+/// \details
+/// A ring buffer of trace records in caller supplied storage, attach it to
+/// a display with ILI9163_spi_res_wrx_cs::capture(). When the buffer is full
+/// the oldest records are overwritten, so it always holds the last
+/// capacity transfers. dump() writes the records as text, the Trace
+/// project reads that text back and reports where the time went.
+///
+/// For a full capture also supply storage for pixel data: the pixels of
+/// each burst, and the bytes of a data burst one per pixel, are then kept
+/// in a second ring, so a replay reproduces images, flushes and LUTs
+/// instead of only their first colour or byte. A pixels record
+/// finds its pixels by position in the stream of all captured pixels,
+/// they are lost when more than pixel_capacity pixels were sent after them.
+class ILI9163_trace {
+private:
+    ILI9163_trace_record * records;
+    size_t capacity;
+    size_t next;
+    size_t used;
+    uint32_t lost;
+
+    uint16_t * pixel_data;
+    size_t pixel_capacity;
+    uint32_t pixel_count;       // pixels captured since the last clear, the next position
+
+public:
+    ILI9163_trace(ILI9163_trace_record * records, size_t capacity,
+                  uint16_t * pixel_data = nullptr, size_t pixel_capacity = 0);
+
+    /// remove all records and pixel data
+    void clear();
+
+    /// add a record of a transfer that started at start (in ticks) and ends now
+    void add(ILI9163_trace_kind kind, uint8_t byte, uint16_t count, uint16_t value, uint32_t start, uint32_t data = 0){
+        if(capacity == 0){
+            return;
+        }
+        records[next] = ILI9163_trace_record{ start, (uint32_t) hwlib::now_ticks(), data, count, value, kind, byte };
+        next = next + 1 < capacity ? next + 1 : 0;
+        if(used < capacity){
+            used++;
+        } else{
+            lost++;
+        }
+    }
+
+    /// position of the next captured pixel in the pixel stream
+    uint32_t pixel_position() const {
+        return pixel_count;
+    }
+
+    /// add n pixels to the pixel data, when the trace has storage for it
+    void add_pixels(const uint16_t data[], size_t n){
+        if(pixel_capacity == 0){
+            return;
+        }
+        for(size_t i = 0; i < n; i++){
+            pixel_data[pixel_count++ % pixel_capacity] = data[i];
+        }
+    }
+
+    /// add n pixels sent as 2 n bytes, high byte first
+    void add_pixel_bytes(const uint8_t data[], size_t n){
+        if(pixel_capacity == 0){
+            return;
+        }
+        for(size_t i = 0; i < n; i++){
+            pixel_data[pixel_count++ % pixel_capacity] = data[2 * i] << 8 | data[2 * i + 1];
+        }
+    }
+
+    /// add n data bytes to the pixel data, one byte per position
+    void add_bytes(const uint8_t data[], size_t n){
+        if(pixel_capacity == 0){
+            return;
+        }
+        for(size_t i = 0; i < n; i++){
+            pixel_data[pixel_count++ % pixel_capacity] = data[i];
+        }
+    }
+
+    /// true when the n pixels from position on are captured and not overwritten
+    bool has_pixels(uint32_t position, size_t n) const;
+
+    /// the captured pixel at position, check has_pixels() first
+    uint16_t pixel(uint32_t position) const {
+        return pixel_data[position % pixel_capacity];
+    }
+
+    /// number of records held
+    size_t size() const {
+        return used;
+    }
+
+    /// number of records overwritten since the last clear
+    uint32_t overwritten() const {
+        return lost;
+    }
+
+    /// record i, 0 is the oldest
+    const ILI9163_trace_record & operator[](size_t i) const {
+        size_t first = used < capacity ? 0 : next;
+        return records[(first + i) % capacity];
+    }
+
+    /// write the records as text, oldest first
+    void dump(hwlib::ostream & out) const;
+};
+
+/// storage of ILI9163_static_trace, a base so it is constructed before the trace uses it
+template< size_t N, size_t PIXELS >
+struct ILI9163_trace_storage {
+    ILI9163_trace_record record_storage[N];
+    uint16_t pixel_storage[PIXELS > 0 ? PIXELS : 1];
+};
+
+/// trace that holds its own storage for N records and PIXELS pixels of data
+template< size_t N, size_t PIXELS = 0 >
+class ILI9163_static_trace : private ILI9163_trace_storage< N, PIXELS >, public ILI9163_trace {
+public:
+    ILI9163_static_trace():
+        ILI9163_trace(this->record_storage, N, this->pixel_storage, PIXELS)
+    {}
+};
+
+#endif //ILI9163_TRACE_HPP
@@ -0,0 +1,365 @@
+#include "hwlib.hpp"
+#include "game.hpp"
+#include "headless.hpp"
+#include "autopilot.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+// Headless snake simulation on the host.
+//
+//   simulation [games] [threads]           play games 1..games on all cores
+//   simulation autopilot [games] [threads] the same with the autopilot as player
+//   simulation replay <seed> [trace-file]  replay one seed, optionally save its input trace
+//   simulation script <seed> <trace-file>  play one seed with the input from a trace file
+//   simulation bench [games]               time game::tick with a full pool of foods,
+//                                          against the objects in an object * array
+//
+// A game is fully determined by its seed (food placement and random player)
+// or by its seed and input trace, so replay and script print the same checksum.
+
+static const uint32_t max_ticks = 100000;
+
+////////////////////////////////////////////////////////////////////////
+
+// random player, presses a button on one tick in eight
+class random_input : public input_source {
+private:
+    xorshift_random rnd;
+
+public:
+    random_input(uint32_t seed):
+        rnd( seed * 2654435761u + 1 )
+    {}
+
+    uint8_t buttons() override {
+        uint32_t r = rnd.next();
+        if((r & 0x07) != 0){
+            return 0;
+        }
+        return 1 << ((r >> 3) & 0x03);
+    }
+}; // class random_input
+
+////////////////////////////////////////////////////////////////////////
+
+struct game_result {
+    game_state state;
+    uint32_t ticks;
+};
+
+game_result play(uint32_t seed, input_source & input, hwlib::window & w){
+    xorshift_random rnd(seed);
+    game g(w, rnd);
+    g.draw();
+
+    game_state state = game_state::running;
+    while(state == game_state::running && g.tick_count() < max_ticks){
+        state = g.tick(input);
+    }
+    return game_result{ state, g.tick_count() };
+}
+
+// the autopilot plays one game, worst_layers is raised to the most search
+// layers one of its decisions expanded
+game_result play_autopilot(uint32_t seed, hwlib::window & w, int & worst_layers){
+    xorshift_random rnd(seed);
+    game g(w, rnd);
+    autopilot player(g);
+    g.draw();
+
+    game_state state = game_state::running;
+    while(state == game_state::running && g.tick_count() < max_ticks){
+        state = g.tick(player);
+        if(player.layers_used() > worst_layers){
+            worst_layers = player.layers_used();
+        }
+    }
+    return game_result{ state, g.tick_count() };
+}
+
+const char * name(game_state state){
+    switch(state){
+        case game_state::won:  return "won";
+        case game_state::lost: return "lost";
+        default:               return "timeout";
+    }
+}
+
+////////////////////////////////////////////////////////////////////////
+
+int bulk(uint32_t games, unsigned int threads, bool use_autopilot){
+    std::atomic< uint32_t > next_seed(1);
+    std::atomic< uint64_t > total_ticks(0);
+    std::atomic< uint32_t > won(0), lost(0), timeout(0);
+    std::atomic< uint64_t > longest(0);   // ticks << 32 | seed
+    std::atomic< int > deepest(0);        // search layers of one autopilot decision
+
+    auto worker = [&](){
+        null_window w;
+        uint64_t ticks = 0;
+        int worst_layers = 0;
+        for(;;){
+            uint32_t seed = next_seed++;
+            if(seed > games){
+                break;
+            }
+            game_result r;
+            if(use_autopilot){
+                r = play_autopilot(seed, w, worst_layers);
+            }else{
+                random_input input(seed);
+                r = play(seed, input, w);
+            }
+            ticks += r.ticks;
+            if(r.state == game_state::won){
+                won++;
+            }else if(r.state == game_state::lost){
+                lost++;
+            }else{
+                timeout++;
+            }
+            uint64_t candidate = ((uint64_t) r.ticks << 32) | seed;
+            uint64_t current = longest.load();
+            while(candidate > current && !longest.compare_exchange_weak(current, candidate)){}
+        }
+        total_ticks += ticks;
+        int current = deepest.load();
+        while(worst_layers > current && !deepest.compare_exchange_weak(current, worst_layers)){}
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector< std::thread > pool;
+    for(unsigned int i = 0; i < threads; i++){
+        pool.emplace_back(worker);
+    }
+    for(auto & t : pool){
+        t.join();
+    }
+    double seconds = std::chrono::duration< double >(std::chrono::steady_clock::now() - start).count();
+
+    std::printf("games    : %u on %u threads%s\n", games, threads, use_autopilot ? " by the autopilot" : "");
+    std::printf("result   : %u won, %u lost, %u timeout\n", won.load(), lost.load(), timeout.load());
+    std::printf("ticks    : %llu in %.3f s\n", (unsigned long long) total_ticks.load(), seconds);
+    std::printf("speed    : %.0f ticks/s, %.0f games/s\n", total_ticks.load() / seconds, games / seconds);
+    std::printf("longest  : seed %u, %u ticks\n", (unsigned) (longest.load() & 0xffffffff), (unsigned) (longest.load() >> 32));
+    if(use_autopilot){
+        std::printf("won      : %.2f %%\n", 100.0 * won.load() / games);
+        std::printf("decision : %d of %d search layers worst case\n", deepest.load(), AUTOPILOT_MAX_LAYERS);
+    }
+    return 0;
+}
+
+int replay(uint32_t seed, const char * trace_file){
+    std::vector< input_step > steps(max_ticks);
+    random_input player(seed);
+    recording_input input(player, steps.data(), steps.size());
+    recording_window w;
+
+    auto r = play(seed, input, w);
+    std::printf("seed %u: %s after %u ticks, checksum %08x\n", seed, name(r.state), r.ticks, w.checksum());
+
+    if(trace_file != nullptr){
+        FILE * f = std::fopen(trace_file, "w");
+        if(f == nullptr){
+            std::fprintf(stderr, "cannot write %s\n", trace_file);
+            return 1;
+        }
+        for(size_t i = 0; i < input.size(); i++){
+            std::fprintf(f, "%u %u\n", steps[i].tick, steps[i].buttons);
+        }
+        std::fclose(f);
+    }
+    return 0;
+}
+
+int script(uint32_t seed, const char * trace_file){
+    FILE * f = std::fopen(trace_file, "r");
+    if(f == nullptr){
+        std::fprintf(stderr, "cannot read %s\n", trace_file);
+        return 1;
+    }
+    std::vector< input_step > steps;
+    unsigned int tick, buttons;
+    while(std::fscanf(f, "%u %u", &tick, &buttons) == 2){
+        steps.push_back(input_step{ tick, (uint8_t) buttons });
+    }
+    std::fclose(f);
+
+    script_input input(steps.data(), steps.size());
+    recording_window w;
+
+    auto r = play(seed, input, w);
+    std::printf("seed %u: %s after %u ticks, checksum %08x\n", seed, name(r.state), r.ticks, w.checksum());
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////
+
+// the game as it was before the pools, with MAX_FOODS foods: the snake and
+// the foods behind object pointers in one array, every pair interacts.
+// Without all_pairs only the pairs with the snake interact, as in game::tick
+class array_game {
+private:
+    snake s;
+    std::vector< food > foods;
+    std::vector< object * > objects;
+
+public:
+    bool all_pairs = true;
+
+    array_game(hwlib::window & w, random_source & rnd):
+        s( w )
+    {
+        foods.reserve(MAX_FOODS);
+        objects.push_back(&s);
+        foods.emplace_back(w, hwlib::xy(100, 63), rnd);
+        for(size_t i = 1; i < MAX_FOODS; i++){
+            foods.emplace_back(w, bench_food(i), rnd);
+        }
+        for(auto & f : foods){
+            objects.push_back(&f);
+        }
+    }
+
+    // the food positions of the benchmark, a grid over the board clear
+    // of each other and of the first food at (100, 63)
+    static hwlib::xy bench_food(size_t i){
+        return hwlib::xy(20 + 12 * (i % 8), 32 + 24 * (i / 8));
+    }
+
+    game_state tick(input_source & input){
+        uint8_t pressed = input.buttons();
+        for(int d = 0; d < 4; d++){
+            if(pressed & (1 << d)){
+                s.directions(d);
+            }
+        }
+
+        for(auto p : objects){
+            p->update();
+        }
+
+        if(all_pairs){
+            for(auto p : objects){
+                for(auto other : objects){
+                    p->interact(*other);
+                }
+            }
+        }else{
+            for(auto other : objects){
+                objects[0]->interact(*other);
+            }
+            for(size_t i = 1; i < objects.size(); i++){
+                objects[i]->interact(*objects[0]);
+            }
+        }
+
+        if(s.win()){
+            return game_state::won;
+        }
+        if(s.death()){
+            return game_state::lost;
+        }
+        return game_state::running;
+    }
+
+    const snake & player() const {
+        return s;
+    }
+}; // class array_game
+
+struct bench_result {
+    double ns = 0;
+    uint64_t ticks = 0;
+    uint64_t eaten = 0;
+};
+
+// games 1 .. games with the random player, only the ticks are timed
+template< typename GAME, typename SETUP >
+bench_result bench_games(uint32_t games, SETUP setup){
+    null_window w;
+    bench_result r;
+    for(uint32_t seed = 1; seed <= games; seed++){
+        xorshift_random rnd(seed);
+        random_input player(seed);
+        GAME g(w, rnd);
+        setup(g);
+
+        // the snake grows one part per tick it overlaps a food
+        int length = 0;
+        game_state state = game_state::running;
+        uint32_t ticks = 0;
+        auto start = std::chrono::steady_clock::now();
+        while(state == game_state::running && ticks < max_ticks){
+            state = g.tick(player);
+            ticks++;
+            int now = g.player().tail_length();
+            if(now > length){
+                r.eaten += now - length;
+            }
+            length = now;
+        }
+        r.ns += std::chrono::duration< double, std::nano >(std::chrono::steady_clock::now() - start).count();
+        r.ticks += ticks;
+    }
+    return r;
+}
+
+// game::tick with MAX_FOODS foods in the pool, against the same game in
+// the object * array layout that game had before the pools, with every
+// pair and with the pairs of game::tick (the same game as the pool)
+int bench(uint32_t games){
+    auto pool = bench_games< game >(games, [](game & g){
+        for(size_t i = 1; i < MAX_FOODS; i++){
+            g.spawn_food(array_game::bench_food(i));
+        }
+    });
+    auto array = bench_games< array_game >(games, [](array_game &){});
+    auto snake_pairs = bench_games< array_game >(games, [](array_game & g){
+        g.all_pairs = false;
+    });
+
+    std::printf("games    : %u with %u foods, random player\n", games, (unsigned) MAX_FOODS);
+    std::printf("           ticks   eaten  interact calls  ns per tick\n");
+    std::printf("pool     : %7llu %7llu %15u %12.1f\n", (unsigned long long) pool.ticks,
+        (unsigned long long) pool.eaten, (unsigned) (1 + 2 * MAX_FOODS), pool.ns / pool.ticks);
+    std::printf("array    : %7llu %7llu %15u %12.1f\n", (unsigned long long) array.ticks,
+        (unsigned long long) array.eaten, (unsigned) ((MAX_FOODS + 1) * (MAX_FOODS + 1)), array.ns / array.ticks);
+    std::printf("array    : %7llu %7llu %15u %12.1f  snake pairs only\n", (unsigned long long) snake_pairs.ticks,
+        (unsigned long long) snake_pairs.eaten, (unsigned) (1 + 2 * MAX_FOODS), snake_pairs.ns / snake_pairs.ticks);
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char * argv[]){
+    if(argc >= 3 && std::strcmp(argv[1], "replay") == 0){
+        return replay(std::strtoul(argv[2], nullptr, 0), argc >= 4 ? argv[3] : nullptr);
+    }
+    if(argc >= 4 && std::strcmp(argv[1], "script") == 0){
+        return script(std::strtoul(argv[2], nullptr, 0), argv[3]);
+    }
+
+    if(argc >= 2 && std::strcmp(argv[1], "bench") == 0){
+        return bench(argc >= 3 ? std::strtoul(argv[2], nullptr, 0) : 2000);
+    }
+
+    bool use_autopilot = argc >= 2 && std::strcmp(argv[1], "autopilot") == 0;
+    if(use_autopilot){
+        argc--;
+        argv++;
+    }
+
+    uint32_t games = argc >= 2 ? std::strtoul(argv[1], nullptr, 0) : 100000;
+    unsigned int threads = argc >= 3 ? std::strtoul(argv[2], nullptr, 0) : std::thread::hardware_concurrency();
+    if(threads == 0){
+        threads = 1;
+    }
+    return bulk(games, threads, use_autopilot);
+}
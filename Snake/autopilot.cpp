@@ -0,0 +1,250 @@
+#include "autopilot.hpp"
+
+////////////////////////////////////////////////////////////////////////////
+
+bool grid_set::any() const {
+    uint32_t all = 0;
+    for(auto row : rows){
+        all |= row;
+    }
+    return all != 0;
+}
+
+grid_set grid_set::grow(const grid_set & blocked) const {
+    static constexpr uint32_t mask = (1u << GRID_SIZE) - 1;
+    grid_set result;
+    for(int y = 0; y < GRID_SIZE; y++){
+        uint32_t next = (rows[y] << 1) | (rows[y] >> 1);
+        if(y > 0){
+            next |= rows[y - 1];
+        }
+        if(y < GRID_SIZE - 1){
+            next |= rows[y + 1];
+        }
+        result.rows[y] = next & mask & ~blocked.rows[y];
+    }
+    return result;
+}
+
+grid_set & grid_set::operator|=(const grid_set & rhs){
+    for(int y = 0; y < GRID_SIZE; y++){
+        rows[y] |= rhs.rows[y];
+    }
+    return *this;
+}
+
+bool grid_set::intersects(const grid_set & rhs) const {
+    uint32_t common = 0;
+    for(int y = 0; y < GRID_SIZE; y++){
+        common |= rows[y] & rhs.rows[y];
+    }
+    return common != 0;
+}
+
+// class grid_set functions
+////////////////////////////////////////////////////////////////////////////
+
+static bool on_grid(hwlib::xy cell){
+    return cell.x >= 0 && cell.x < GRID_SIZE && cell.y >= 0 && cell.y < GRID_SIZE;
+}
+
+static hwlib::xy grid_cell(hwlib::xy pixel){
+    int x = pixel.x - GRID_X0;
+    int y = pixel.y - GRID_Y0;
+    if(x < 0 || y < 0 || x % GRID_STEP != 0 || y % GRID_STEP != 0){
+        return hwlib::xy(-1, -1);
+    }
+    return hwlib::xy(x / GRID_STEP, y / GRID_STEP);
+}
+
+// the position of a cell on a Hamiltonian cycle of the grid: along row 0 to the right,
+// down through the other rows in a zig-zag over columns 1 .. 25, and up column 0
+static int cycle_index(hwlib::xy cell){
+    static constexpr int last = GRID_SIZE - 1;
+    if(cell.y == 0){
+        return cell.x;
+    }
+    if(cell.x == 0){
+        return GRID_SIZE + last * last + (last - cell.y);
+    }
+    int row = GRID_SIZE + (cell.y - 1) * last;
+    return row + (cell.y % 2 == 1 ? last - cell.x : cell.x - 1);
+}
+
+// how far b is ahead of a along the cycle
+static int cycle_distance(int a, int b){
+    return (b - a + GRID_SIZE * GRID_SIZE) % (GRID_SIZE * GRID_SIZE);
+}
+
+// search() result when the layer budget of the decision ran out
+static constexpr int out_of_layers = -2;
+
+// the movement that snake::directions(d) selects
+static const hwlib::xy moves[4] = {
+    hwlib::xy(-1, 0), hwlib::xy(1, 0), hwlib::xy(0, -1), hwlib::xy(0, 1)
+};
+
+////////////////////////////////////////////////////////////////////////////
+
+void autopilot::scan(){
+    const snake & s = g.player();
+
+    // tail cell i is left after i + 1 ticks, the head after all of them
+    cell_count = 0;
+    for(int i = 0; i < s.tail_length(); i++){
+        cells[cell_count++] = grid_cell(s.tail_at(i));
+    }
+    cells[cell_count++] = grid_cell(s.position());
+
+    body.clear();
+    for(int i = 0; i < cell_count; i++){
+        if(on_grid(cells[i])){
+            body.set(cells[i].x, cells[i].y);
+            free_at[cells[i].y * GRID_SIZE + cells[i].x] = i + 1;
+        }
+    }
+}
+
+void autopilot::release(int tick, grid_set & blocked){
+    int i = tick - 1;
+    if(i >= 0 && i < cell_count && on_grid(cells[i]) && free_at[cells[i].y * GRID_SIZE + cells[i].x] == tick){
+        blocked.reset(cells[i].x, cells[i].y);
+    }
+}
+
+int autopilot::search(hwlib::xy start, const grid_set & goal){
+    if(goal.test(start.x, start.y)){
+        return 1;
+    }
+
+    grid_set blocked = body;
+    release(1, blocked);
+    grid_set visited;
+    grid_set frontier;
+    frontier.set(start.x, start.y);
+    visited.set(start.x, start.y);
+
+    // one layer per tick, the head can be in the frontier cells after tick ticks
+    for(int tick = 2; ; tick++){
+        if(layers_left == 0){
+            return out_of_layers;
+        }
+        layers_left--;
+        release(tick, blocked);
+
+        grid_set seen = visited;
+        seen |= blocked;
+        frontier = frontier.grow(seen);
+        if(!frontier.any()){
+            return -1;
+        }
+        if(frontier.intersects(goal)){
+            return tick;
+        }
+        visited |= frontier;
+    }
+}
+
+// the buttons that move the head to the next cell on the cycle
+static uint8_t follow_cycle(hwlib::xy head, int h){
+    for(int d = 0; d < 4; d++){
+        hwlib::xy next = head + moves[d];
+        if(on_grid(next) && cycle_distance(h, cycle_index(next)) == 1){
+            return 1 << d;
+        }
+    }
+    return 0;
+}
+
+uint8_t autopilot::buttons(){
+    layers_left = AUTOPILOT_MAX_LAYERS;
+    scan();
+
+    const snake & s = g.player();
+    hwlib::xy head = grid_cell(s.position());
+    if(!on_grid(head)){
+        return 0;
+    }
+    int h = cycle_index(head);
+
+    // the head may only move ahead along the cycle, and not as far as the tail,
+    // so the snake always lies on one stretch of the cycle and can follow it.
+    // The tail stays in place for one tick for each part the snake still
+    // grows: the parts that have not grown yet (tail entries off the grid)
+    // and the food still to come. Shortcuts keep that many cells spare.
+    int room = GRID_SIZE * GRID_SIZE;
+    int spare = ARRAY_SIZE - s.tail_length() + 1;
+    bool tail = false;
+    for(int i = 0; i < cell_count - 1; i++){
+        if(!on_grid(cells[i])){
+            spare++;
+        }else if(!tail){
+            room = cycle_distance(h, cycle_index(cells[i]));
+            tail = true;
+        }
+    }
+    room -= spare;
+
+    // the cells where the head touches the food, and the first of them along the cycle
+    const food & f = g.target();
+    grid_set goal;
+    int to_food = GRID_SIZE * GRID_SIZE;
+    for(int y = 0; y < GRID_SIZE; y++){
+        int py = GRID_Y0 + y * GRID_STEP;
+        if(py < f.position().y || py > f.position().y + f.extent().y){
+            continue;
+        }
+        for(int x = 0; x < GRID_SIZE; x++){
+            int px = GRID_X0 + x * GRID_STEP;
+            if(px >= f.position().x && px <= f.position().x + f.extent().x){
+                goal.set(x, y);
+                // food under the head is only eaten after a round along the cycle
+                int d = cycle_distance(h, cycle_index(hwlib::xy(x, y)));
+                if(d > 0 && d < to_food){
+                    to_food = d;
+                }
+            }
+        }
+    }
+
+    // of the allowed moves, take the one with the shortest path to the food
+    // that does not pass the food on the cycle, else the longest step along the cycle
+    int best = -1;
+    int best_food = -1;
+    int best_step = 0;
+    for(int d = 0; d < 4; d++){
+        hwlib::xy next = head + moves[d];
+        if(moves[d] == hwlib::xy(0, 0) - s.heading() || !on_grid(next)){
+            continue;
+        }
+        if(body.test(next.x, next.y) && free_at[next.y * GRID_SIZE + next.x] > 1){
+            continue;
+        }
+        int step = cycle_distance(h, cycle_index(next));
+        if(step == 0 || (step > 1 && step >= room) || step > to_food){
+            continue;
+        }
+
+        int food = search(next, goal);
+        if(food == out_of_layers){
+            return follow_cycle(head, h);
+        }
+        bool better = best < 0;
+        if(!better && food >= 0){
+            better = best_food < 0 || food < best_food || (food == best_food && step > best_step);
+        }
+        if(!better && food < 0 && best_food < 0){
+            better = step > best_step;
+        }
+        if(better){
+            best = d;
+            best_food = food;
+            best_step = step;
+        }
+    }
+
+    return best < 0 ? 0 : 1 << best;
+}
+
+// class autopilot functions
+////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,100 @@
+#include "game.hpp"
+
+////////////////////////////////////////////////////////////////////////////
+
+game::game(hwlib::window & w, random_source & rnd):
+        w( w ),
+        rnd( rnd ),
+        s( w ),
+        ticks( 0 )
+{
+    // in drawing order
+    spawn_wall( hwlib::xy(  0, 121 ), hwlib::xy( 129, 129 ));
+    spawn_wall( hwlib::xy( 0,  0 ), hwlib::xy( 8, 129 ), false);
+    spawn_wall( hwlib::xy( 121,  0 ), hwlib::xy( 129, 129 ),false);
+    spawn_wall( hwlib::xy(   0,  0 ), hwlib::xy( 129,  8));
+    spawn_food( hwlib::xy(100, 63) );
+}
+
+wall * game::spawn_wall(const hwlib::xy & location, const hwlib::xy & size, bool ij, bool filled){
+    return walls.spawn(w, location, size, ij, filled);
+}
+
+food * game::spawn_food(const hwlib::xy & midpoint){
+    food * f = foods.spawn(w, midpoint, rnd);
+    if(f == nullptr){
+        return nullptr;
+    }
+
+    // the foods do not interact with each other in tick(), so a food
+    // on top of another would stay there
+    bool free = true;
+    foods.for_each([f, &free](food & x){
+        if(&x != f && f->overlaps(x)){
+            free = false;
+        }
+    });
+    if(!free){
+        foods.despawn(f);
+        return nullptr;
+    }
+    return f;
+}
+
+void game::despawn_food(food * f){
+    if(foods.size() > 1){
+        foods.despawn(f);
+    }
+}
+
+void game::draw(){
+    walls.for_each([](wall & x){
+        x.draw();
+    });
+    s.draw();
+    foods.for_each([](food & x){
+        x.draw();
+    });
+}
+
+game_state game::tick(input_source & input){
+
+    uint8_t pressed = input.buttons();
+    for(int d = 0; d < 4; d++){
+        if(pressed & (1 << d)){
+            s.directions(d);
+        }
+    }
+
+    s.update();
+    foods.for_each([](food & x){
+        x.update();
+    });
+
+    // the snake with itself and every food, then every food with the snake.
+    // The foods do not interact with each other: an eaten food moves to a
+    // random place and may land on another food, where both stay until
+    // they are eaten. spawn_food() refuses a food on top of another.
+    s.interact(s);
+    foods.for_each([this](food & x){
+        s.interact(x);
+    });
+    foods.for_each([this](food & x){
+        x.interact(s);
+    });
+
+    ticks++;
+
+    if(s.win()){
+        return game_state::won;
+    }
+
+    if(s.death()){
+        return game_state::lost;
+    }
+
+    return game_state::running;
+}
+
+// class game functions
+////////////////////////////////////////////////////////////////////////////
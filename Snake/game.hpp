@@ -0,0 +1,63 @@
+#ifndef GAME_HPP
+#define GAME_HPP
+
+#include "hwlib.hpp"
+#include "snake.hpp"
+#include "random.hpp"
+#include "input.hpp"
+#include "pool.hpp"
+
+#define MAX_WALLS 8             // walls a level can have
+#define MAX_FOODS 32            // foods a level can have
+
+enum class game_state { running, won, lost };
+
+////////////////////////////////////////////////////////////////////////
+
+// one game of snake, independent of the display and the buttons
+//
+// The walls and foods live in pools inside the game, so a level can add
+// and remove them while it runs without a heap.
+class game {
+private:
+    hwlib::window & w;
+    random_source & rnd;
+    pool< wall, MAX_WALLS > walls;
+    snake s;
+    pool< food, MAX_FOODS > foods;
+    uint32_t ticks;
+
+public:
+    game(hwlib::window & w, random_source & rnd);
+    void draw();
+    game_state tick(input_source & input);
+
+    // add a wall or a food, nullptr when its pool is full,
+    // or for a food when it would overlap another food
+    wall * spawn_wall(const hwlib::xy & location, const hwlib::xy & size, bool ij = true, bool filled = true);
+    food * spawn_food(const hwlib::xy & midpoint);
+
+    // remove a food, the game must keep at least one
+    void despawn_food(food * f);
+
+    size_t food_count() const {
+        return foods.size();
+    }
+
+    uint32_t tick_count() const {
+        return ticks;
+    }
+
+    const snake & player() const {
+        return s;
+    }
+
+    // the first food
+    const food & target() const {
+        return *foods.first();
+    }
+}; // class game
+
+////////////////////////////////////////////////////////////////////////
+
+#endif //GAME_HPP
@@ -0,0 +1,65 @@
+#ifndef HEADLESS_HPP
+#define HEADLESS_HPP
+
+#include "hwlib.hpp"
+#include <cstdint>
+
+////////////////////////////////////////////////////////////////////////
+
+// window that ignores everything written to it
+class null_window : public hwlib::window {
+private:
+    void write_implementation(hwlib::xy pos, hwlib::color col) override {}
+    void clear_implementation(hwlib::color col) override {}
+
+public:
+    null_window(const hwlib::xy & size = hwlib::xy(130, 129)):
+        window( size, hwlib::black, hwlib::white )
+    {}
+}; // class null_window
+
+////////////////////////////////////////////////////////////////////////
+
+// window that folds every write into a checksum, two runs that draw
+// the same pixels in the same order give the same checksum
+class recording_window : public hwlib::window {
+private:
+    uint32_t hash;
+    uint32_t count;
+
+    void add(uint32_t value){
+        // FNV-1a
+        hash = (hash ^ value) * 16777619u;
+    }
+
+    void write_implementation(hwlib::xy pos, hwlib::color col) override {
+        add(((uint32_t) pos.x << 16) | (uint32_t) pos.y);
+        add(((uint32_t) col.red << 16) | ((uint32_t) col.green << 8) | col.blue);
+        count++;
+    }
+
+    void clear_implementation(hwlib::color col) override {
+        add(0xffffffff);
+        add(((uint32_t) col.red << 16) | ((uint32_t) col.green << 8) | col.blue);
+        count++;
+    }
+
+public:
+    recording_window(const hwlib::xy & size = hwlib::xy(130, 129)):
+        window( size, hwlib::black, hwlib::white ),
+        hash( 2166136261u ),
+        count( 0 )
+    {}
+
+    uint32_t checksum() const {
+        return hash;
+    }
+
+    uint32_t writes() const {
+        return count;
+    }
+}; // class recording_window
+
+////////////////////////////////////////////////////////////////////////
+
+#endif //HEADLESS_HPP
@@ -0,0 +1,135 @@
+#ifndef INPUT_HPP
+#define INPUT_HPP
+
+#include "hwlib.hpp"
+#include <cstdint>
+#include <cstddef>
+
+// bit d of a button mask requests snake::directions(d)
+#define INPUT_RIGHT  0x01
+#define INPUT_LEFT   0x02
+#define INPUT_UP     0x04
+#define INPUT_DOWN   0x08
+
+////////////////////////////////////////////////////////////////////////
+
+// abstract input source, asked once per game tick
+class input_source {
+public:
+    virtual uint8_t buttons() = 0;
+    virtual ~input_source() = default;
+}; // class input_source
+
+////////////////////////////////////////////////////////////////////////
+
+// the four push buttons, active low
+class button_input : public input_source {
+private:
+    hwlib::pin_in_out & right;
+    hwlib::pin_in_out & left;
+    hwlib::pin_in_out & up;
+    hwlib::pin_in_out & down;
+
+public:
+    button_input(hwlib::pin_in_out & right, hwlib::pin_in_out & left, hwlib::pin_in_out & up, hwlib::pin_in_out & down):
+        right( right ),
+        left( left ),
+        up( up ),
+        down( down )
+    {}
+
+    uint8_t buttons() override {
+        uint8_t mask = 0;
+        if(!right.read()){ mask |= INPUT_RIGHT; }
+        if(!left.read()){  mask |= INPUT_LEFT;  }
+        if(!up.read()){    mask |= INPUT_UP;    }
+        if(!down.read()){  mask |= INPUT_DOWN;  }
+        return mask;
+    }
+}; // class button_input
+
+////////////////////////////////////////////////////////////////////////
+
+// one entry of an input script: the buttons held during one tick
+struct input_step {
+    uint32_t tick;
+    uint8_t buttons;
+};
+
+// replays a recorded input script, ticks that are not in the script press nothing
+class script_input : public input_source {
+private:
+    const input_step * steps;
+    size_t count;
+    size_t next;
+    uint32_t tick;
+
+public:
+    script_input(const input_step * steps, size_t count):
+        steps( steps ),
+        count( count ),
+        next( 0 ),
+        tick( 0 )
+    {}
+
+    uint8_t buttons() override {
+        uint8_t mask = 0;
+        while(next < count && steps[next].tick <= tick){
+            if(steps[next].tick == tick){
+                mask |= steps[next].buttons;
+            }
+            next++;
+        }
+        tick++;
+        return mask;
+    }
+}; // class script_input
+
+////////////////////////////////////////////////////////////////////////
+
+// passes another source through and records every tick that pressed something
+class recording_input : public input_source {
+private:
+    input_source & source;
+    input_step * steps;
+    size_t capacity;
+    size_t count;
+    uint32_t tick;
+    bool lost;
+
+public:
+    recording_input(input_source & source, input_step * steps, size_t capacity):
+        source( source ),
+        steps( steps ),
+        capacity( capacity ),
+        count( 0 ),
+        tick( 0 ),
+        lost( false )
+    {}
+
+    uint8_t buttons() override {
+        uint8_t mask = source.buttons();
+        if(mask != 0){
+            if(count < capacity){
+                steps[count++] = input_step{ tick, mask };
+            }else{
+                lost = true;
+            }
+        }
+        tick++;
+        return mask;
+    }
+
+    size_t size() const {
+        return count;
+    }
+
+    // true when the script buffer was too small to hold the whole game
+    bool overflow() const {
+        return lost;
+    }
+}; // class recording_input
+
+////////////////////////////////////////////////////////////////////////
+
+#endif //INPUT_HPP
@@ -0,0 +1,36 @@
+#include "input_queue.hpp"
+
+#ifdef BMPTK_TARGET_arduino_due
+
+////////////////////////////////////////////////////////////////////////////
+
+static input_sampler * active_sampler = nullptr;
+
+void start_input_timer(input_sampler & sampler){
+    active_sampler = &sampler;
+
+    // TC1 channel 0 is peripheral TC3, clocked at MCK / 128
+    PMC->PMC_PCER0 = 1 << ID_TC3;
+    TC1->TC_CHANNEL[0].TC_CCR = TC_CCR_CLKDIS;
+    TC1->TC_CHANNEL[0].TC_CMR = TC_CMR_TCCLKS_TIMER_CLOCK4 | TC_CMR_WAVE | TC_CMR_WAVSEL_UP_RC;
+    TC1->TC_CHANNEL[0].TC_RC = (uint64_t) 84'000'000 / 128 * sampler.period() / 1'000'000;
+    TC1->TC_CHANNEL[0].TC_IER = TC_IER_CPCS;
+    TC1->TC_CHANNEL[0].TC_IDR = ~TC_IER_CPCS;
+
+    NVIC_ClearPendingIRQ(TC3_IRQn);
+    NVIC_EnableIRQ(TC3_IRQn);
+    TC1->TC_CHANNEL[0].TC_CCR = TC_CCR_CLKEN | TC_CCR_SWTRG;
+}
+
+extern "C" void TC3_Handler(){
+    // reading the status register acknowledges the interrupt
+    (void) TC1->TC_CHANNEL[0].TC_SR;
+    if(active_sampler != nullptr){
+        active_sampler->sample();
+    }
+}
+
+// timer interrupt functions
+////////////////////////////////////////////////////////////////////////////
+
+#endif
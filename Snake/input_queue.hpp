@@ -0,0 +1,173 @@
+#ifndef INPUT_QUEUE_HPP
+#define INPUT_QUEUE_HPP
+
+#include "hwlib.hpp"
+#include "input.hpp"
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+////////////////////////////////////////////////////////////////////////
+
+// lock-free single producer / single consumer queue,
+// push is called from the sampler (interrupt), pop from the game loop
+template< typename T, size_t N >
+class spsc_queue {
+    static_assert( N >= 2 && (N & (N - 1)) == 0, "N must be a power of two" );
+
+private:
+    T items[N];
+    std::atomic< uint32_t > head;   // next slot to read, written by the consumer
+    std::atomic< uint32_t > tail;   // next slot to write, written by the producer
+
+public:
+    spsc_queue():
+        head( 0 ),
+        tail( 0 )
+    {}
+
+    // returns false when the queue is full, the item is then dropped
+    bool push(const T & item){
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        if(t - head.load(std::memory_order_acquire) == N){
+            return false;
+        }
+        items[t & (N - 1)] = item;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // returns false when the queue is empty
+    bool pop(T & item){
+        uint32_t h = head.load(std::memory_order_relaxed);
+        if(h == tail.load(std::memory_order_acquire)){
+            return false;
+        }
+        item = items[h & (N - 1)];
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const {
+        return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+    }
+}; // class spsc_queue
+
+////////////////////////////////////////////////////////////////////////
+
+// a debounced button press, direction is the snake::directions() value,
+// timestamp_us the time of the sample that confirmed it, counted in sample
+// periods from the start of the sampler
+struct direction_event {
+    uint8_t direction;
+    uint32_t timestamp_us;
+};
+
+using direction_queue = spsc_queue< direction_event, 16 >;
+
+////////////////////////////////////////////////////////////////////////
+
+// integrating debouncer: the state only changes after
+// the raw input has agreed with it for threshold samples in a row
+class debouncer {
+private:
+    uint8_t threshold;
+    uint8_t count;
+    bool state;
+
+public:
+    debouncer(uint8_t threshold = 5):
+        threshold( threshold ),
+        count( 0 ),
+        state( false )
+    {}
+
+    // feed one raw sample, returns true on a debounced press
+    bool sample(bool pressed){
+        if(pressed == state){
+            count = 0;
+            return false;
+        }
+        if(++count < threshold){
+            return false;
+        }
+        count = 0;
+        state = pressed;
+        return state;
+    }
+
+    bool pressed() const {
+        return state;
+    }
+}; // class debouncer
+
+////////////////////////////////////////////////////////////////////////
+
+// samples the four (active low) buttons at a fixed rate and
+// pushes a direction_event for every debounced press
+class input_sampler {
+private:
+    hwlib::pin_in_out * pins[4];
+    debouncer buttons[4];
+    direction_queue & queue;
+    uint32_t period_us;
+    uint32_t time_us;
+
+public:
+    input_sampler(hwlib::pin_in_out & right, hwlib::pin_in_out & left,
+                  hwlib::pin_in_out & up, hwlib::pin_in_out & down,
+                  direction_queue & queue, uint32_t period_us = 1000):
+        pins{ &right, &left, &up, &down },
+        queue( queue ),
+        period_us( period_us ),
+        time_us( 0 )
+    {}
+
+    // call once per period, from a timer interrupt or a polling loop
+    void sample(){
+        time_us += period_us;
+        for(uint8_t d = 0; d < 4; d++){
+            if(buttons[d].sample(!pins[d]->read())){
+                queue.push(direction_event{ d, time_us });
+            }
+        }
+    }
+
+    // the time between two samples, start_input_timer() samples at this rate
+    uint32_t period() const {
+        return period_us;
+    }
+}; // class input_sampler
+
+////////////////////////////////////////////////////////////////////////
+
+// game input from the event queue, one press per tick so that
+// two quick turns within one tick are both played
+class queued_input : public input_source {
+private:
+    direction_queue & queue;
+
+public:
+    queued_input(direction_queue & queue):
+        queue( queue )
+    {}
+
+    uint8_t buttons() override {
+        direction_event e;
+        if(queue.pop(e)){
+            return 1 << e.direction;
+        }
+        return 0;
+    }
+}; // class queued_input
+
+////////////////////////////////////////////////////////////////////////
+
+#ifdef BMPTK_TARGET_arduino_due
+
+// call sampler.sample() every sampler.period() from the TC3 (timer 1 channel 0) interrupt
+void start_input_timer(input_sampler & sampler);
+
+#endif
+
+#endif //INPUT_QUEUE_HPP
@@ -1,5 +1,10 @@
 #include "hwlib.hpp"
-#include "snake.hpp"
+#include "ILI9163.hpp"
+#include "ILI9163_spi_fast.hpp"
+#include "ILI9163_power.hpp"
+#include "game.hpp"
+#include "input_queue.hpp"
+#include "autopilot.hpp"
 
 int main( void ) {
     namespace target = hwlib::target;
@@ -9,7 +14,9 @@ int main( void ) {
     auto cs = target::pin_out(target::pins::d8);
     auto wrx = target::pin_out(target::pins::d2);
     auto res = target::pin_out(target::pins::d9);
-    auto spi_bus = hwlib::spi_bus_bit_banged_sclk_mosi_miso(scl, sda, hwlib::pin_in_dummy);
+    // scl and sda (PB13 and PB12) are configured as outputs above,
+    // the bus writes them directly through the PIOB registers
+    auto spi_bus = ILI9163_spi_bus_bit_banged_sclk_mosi< ILI9163_pio_sam3x >(*PIOB, 1 << 13, 1 << 12);
     auto ILI9163 = ILI9163_display(spi_bus, res, wrx, cs);
     auto knop_right = target::pin_in_out(target::pins::d22);
     auto knop_left = target::pin_in_out(target::pins::d24);
@@ -20,65 +27,48 @@ int main( void ) {
     knop_left.direction_set_input();
     knop_up.direction_set_input();
 
+    // the buttons are sampled and debounced at 1 kHz, the game drains the presses each tick
+    direction_queue events;
+    input_sampler sampler(knop_right, knop_left, knop_up, knop_down, events, 1000);
+    start_input_timer(sampler);
+    auto knoppen = queued_input(events);
+    auto rnd = hwlib_random();
+
     ILI9163.clear(hwlib::white);
 
-    wall bottom( ILI9163, hwlib::xy(   0,  0 ), hwlib::xy( 129,  8));
-    wall top( ILI9163, hwlib::xy( 121,  0 ), hwlib::xy( 129, 129 ),false);
-    wall left( ILI9163, hwlib::xy(  0, 121 ), hwlib::xy( 129, 129 ));
-    wall right( ILI9163, hwlib::xy( 0,  0 ), hwlib::xy( 8, 129 ), false);
-    snake s(ILI9163);
-    food f(ILI9163, hwlib::xy(100, 63));
+    game g(ILI9163, rnd);
+    g.draw();
 
-    std::array< object *, 2> objects = {&s, &f};
+#ifdef SNAKE_AUTOPILOT
+    // soak test: the autopilot plays instead of the buttons
+    autopilot player(g);
+    input_source & input = player;
+#else
+    input_source & input = knoppen;
+#endif
 
-    left.draw();
-    right.draw();
-    top.draw();
-    bottom.draw();
-    s.draw();
-    f.draw();
+    game_state state;
 
-    bool result;
+    // 10 ticks per second, the CPU sleeps between the ticks
+    // and is woken up by the input timer
+    ILI9163_frame_pacer pacer(10);
 
     for(;;) {
 
-        hwlib::wait_ms(100);
-
-        if(!knop_right.read()){
-            s.directions(0);
-        } if(!knop_left.read()){
-            s.directions(1);
-        } if(!knop_up.read()){
-            s.directions(2);
-        }if(!knop_down.read()){
-            s.directions(3);
-        }
-
-        for (auto &p : objects) {
-            p->update();
-        }
-
-        for (auto &p : objects) {
-            for (auto &other : objects) {
-                p->interact(*other);
-            }
-        }
-
-        if(s.win()){
-            result = true;
-            break;
-        }
+        pacer.wait();
 
-        if(s.death()){
-            result = false;
+        state = g.tick(input);
+        if(state != game_state::running){
             break;
-
         }
     }
 
-    if(result){
+    if(state == game_state::won){
         ILI9163.clear(hwlib::blue);
     }else{
         ILI9163.clear(hwlib::red);
     }
+
+    // the end screen is static and only uses colours that idle mode can show
+    ILI9163.idle_mode(true);
 }
@@ -0,0 +1,161 @@
+#ifndef POOL_HPP
+#define POOL_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <new>
+#include <utility>
+
+////////////////////////////////////////////////////////////////////////
+
+// class pool
+//
+// Fixed storage for up to N objects of one type, without a heap.
+// The objects are constructed in place in one contiguous array, spawn
+// and despawn are O(1) through a stack of free slots, and a bit per slot
+// marks the live ones so iteration skips empty slots a word at a time.
+// Iteration is in slot order, a freed slot is reused first.
+//
+// Calls through a T & are only direct (not virtual) calls when T is final,
+// which is why the game objects are.
+template< typename T, size_t N >
+class pool {
+    static_assert( N >= 1 && N <= 0xffff, "N must be 1 .. 65535" );
+
+private:
+    static constexpr size_t words = (N + 31) / 32;
+
+    alignas( T ) unsigned char storage[N][sizeof( T )];
+    uint32_t alive[words];
+    uint16_t free_slots[N];
+    size_t free_count;
+
+    T * slot(size_t i){
+        return std::launder(reinterpret_cast< T * >(storage[i]));
+    }
+
+    const T * slot(size_t i) const {
+        return std::launder(reinterpret_cast< const T * >(storage[i]));
+    }
+
+public:
+    pool():
+        alive{},
+        free_count( N )
+    {
+        // slot 0 on top of the stack
+        for(size_t i = 0; i < N; i++){
+            free_slots[i] = N - 1 - i;
+        }
+    }
+
+    pool(const pool &) = delete;
+    pool & operator=(const pool &) = delete;
+
+    ~pool(){
+        clear();
+    }
+
+    // construct an object from args in a free slot, nullptr when the pool is full
+    template< typename... Args >
+    T * spawn(Args &&... args){
+        if(free_count == 0){
+            return nullptr;
+        }
+        size_t i = free_slots[--free_count];
+        alive[i / 32] |= 1u << (i % 32);
+        return new (storage[i]) T(std::forward< Args >(args)...);
+    }
+
+    // destroy an object of this pool and free its slot
+    void despawn(T * p){
+        size_t i = index(p);
+        alive[i / 32] &= ~(1u << (i % 32));
+        p->~T();
+        free_slots[free_count++] = i;
+    }
+
+    // destroy all objects
+    void clear(){
+        for_each([this](T & item){
+            despawn(&item);
+        });
+    }
+
+    // the slot of an object of this pool
+    size_t index(const T * p) const {
+        return (reinterpret_cast< const unsigned char * >(p) - storage[0]) / sizeof( T );
+    }
+
+    bool is_alive(size_t i) const {
+        return (alive[i / 32] >> (i % 32)) & 1;
+    }
+
+    // the object in slot i, which must be alive
+    T & operator[](size_t i){
+        return *slot(i);
+    }
+
+    const T & operator[](size_t i) const {
+        return *slot(i);
+    }
+
+    // the live object with the lowest slot, nullptr when there is none
+    T * first(){
+        for(size_t w = 0; w < words; w++){
+            if(alive[w] != 0){
+                return slot(w * 32 + __builtin_ctz(alive[w]));
+            }
+        }
+        return nullptr;
+    }
+
+    const T * first() const {
+        return const_cast< pool * >(this)->first();
+    }
+
+    size_t size() const {
+        return N - free_count;
+    }
+
+    bool empty() const {
+        return free_count == N;
+    }
+
+    bool full() const {
+        return free_count == 0;
+    }
+
+    static constexpr size_t capacity(){
+        return N;
+    }
+
+    // call f(T &) for every live object, f may despawn the object it is given
+    template< typename F >
+    void for_each(F f){
+        for(size_t w = 0; w < words; w++){
+            uint32_t bits = alive[w];
+            while(bits != 0){
+                size_t i = w * 32 + __builtin_ctz(bits);
+                bits &= bits - 1;
+                f(*slot(i));
+            }
+        }
+    }
+
+    template< typename F >
+    void for_each(F f) const {
+        for(size_t w = 0; w < words; w++){
+            uint32_t bits = alive[w];
+            while(bits != 0){
+                size_t i = w * 32 + __builtin_ctz(bits);
+                bits &= bits - 1;
+                f(*slot(i));
+            }
+        }
+    }
+}; // class pool
+
+////////////////////////////////////////////////////////////////////////
+
+#endif //POOL_HPP
@@ -0,0 +1,48 @@
+#ifndef RANDOM_HPP
+#define RANDOM_HPP
+
+#include "hwlib.hpp"
+#include <cstdint>
+
+////////////////////////////////////////////////////////////////////////
+
+// abstract random number source
+class random_source {
+public:
+    virtual uint32_t next() = 0;
+    virtual ~random_source() = default;
+}; // class random_source
+
+////////////////////////////////////////////////////////////////////////
+
+// random numbers from hwlib, used on the target
+class hwlib_random : public random_source {
+public:
+    uint32_t next() override {
+        return hwlib::rand();
+    }
+}; // class hwlib_random
+
+////////////////////////////////////////////////////////////////////////
+
+// seedable xorshift32 generator, the same seed always gives the same game
+class xorshift_random : public random_source {
+private:
+    uint32_t state;
+
+public:
+    xorshift_random(uint32_t seed):
+        state( seed != 0 ? seed : 0x9e3779b9 )
+    {}
+
+    uint32_t next() override {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+}; // class xorshift_random
+
+////////////////////////////////////////////////////////////////////////
+
+#endif //RANDOM_HPP
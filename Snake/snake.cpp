@@ -238,8 +238,8 @@ void food::interact(object &other) {
             c.draw( w );
             int x;
             int y;
-            x = hwlib::rand() % 121;
-            y = hwlib::rand() % 121;
+            x = rnd.next() % 121;
+            y = rnd.next() % 121;
             x = constrain(x, 8 + 10, 121 - 10);
             y = constrain(y, 8 + 10, 121 - 10);
             location = hwlib::xy(x, y);
@@ -2,7 +2,7 @@
 #define SNAKE_HPP
 
 #include "hwlib.hpp"
-#include "ILI9163.hpp"
+#include "random.hpp"
 #include <array>
 #include <cmath>
 
@@ -32,6 +32,14 @@ public:
     bool overlaps( const object & other );
     virtual void interact( object & other ){}
     bool operator==(const object & rhs);
+
+    hwlib::xy position() const {
+        return location;
+    }
+
+    hwlib::xy extent() const {
+        return size;
+    }
 }; // class object
 
 ////////////////////////////////////////////////////////////////////////
@@ -68,7 +76,7 @@ public:
 ///////////////////////////////////////////////////////////////////////
 
 // class snake
-class snake : public object{
+class snake final : public object{
 
 private:
     int length;
@@ -102,6 +110,20 @@ public:
     bool win();
     bool death();
 
+    // the current direction of movement, (1, 0) is to the right
+    hwlib::xy heading() const {
+        return speed;
+    }
+
+    int tail_length() const {
+        return length;
+    }
+
+    // tail_at(0) is the oldest part of the tail, tail_at(tail_length() - 1) the newest
+    hwlib::xy tail_at(int i) const {
+        return tail[i];
+    }
+
 }; // class snake
 
 //////////////////////////////////////////////////////////////////////
@@ -130,11 +152,13 @@ public:
 /////////////////////////////////////////////////////////////////////
 
 // class food
-class food : public circle{
+class food final : public circle{
     bool drwan;
+    random_source & rnd;
 public:
-    food(hwlib::window & w, const hwlib::xy & midpoint):
-        circle(w, midpoint, 3)
+    food(hwlib::window & w, const hwlib::xy & midpoint, random_source & rnd):
+        circle(w, midpoint, 3),
+        rnd(rnd)
     {
         drwan = false;
     }
@@ -145,7 +169,7 @@ public:
 /////////////////////////////////////////////////////////////////////
 
 // class wall
-class wall : public object{
+class wall final : public object{
 
 private:
     line left, right, top, bottom;
@@ -0,0 +1,368 @@
+#include "hwlib.hpp"
+#include "ILI9163.hpp"
+#include "ILI9163_trace.hpp"
+#include "ILI9163_simulator.hpp"
+#include "ILI9163_display_list.hpp"
+#include "game.hpp"
+#include "autopilot.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+// Analyses a traffic trace dumped by ILI9163_trace::dump().
+//
+//   trace <dump-file>              report the time per kind of transfer,
+//                                  the address windows and the longest gaps
+//   trace <dump-file> <frame.ppm>  also replay the trace into the simulator
+//                                  and save the resulting display contents
+//   trace check                    play Snake on simulated displays with a full
+//                                  capture and check that replaying the trace
+//                                  gives the same graphics memory
+//
+// The dump may be cut from a serial log, text before the
+// "ILI9163 trace begin" line and after the end line is ignored.
+
+////////////////////////////////////////////////////////////////////////
+
+struct trace_dump {
+    unsigned int ticks_per_us = 84;
+    unsigned int lost = 0;
+    std::vector< ILI9163_trace_record > records;
+    uint32_t pixel_first = 0;
+    std::vector< uint16_t > pixel_data;
+
+    // the captured pixels of a pixels or bytes record, nullptr when they are not in the dump
+    const uint16_t * pixels(const ILI9163_trace_record & r) const {
+        if((r.kind != ILI9163_trace_kind::pixels && r.kind != ILI9163_trace_kind::bytes) || r.data < pixel_first
+            || r.data - pixel_first + r.count > pixel_data.size()){
+            return nullptr;
+        }
+        return pixel_data.data() + (r.data - pixel_first);
+    }
+};
+
+bool read_dump(FILE * f, trace_dump & dump){
+    char line[256];
+    bool inside = false;
+    bool pixel_lines = false;
+    while(std::fgets(line, sizeof(line), f) != nullptr){
+        if(std::strncmp(line, "ILI9163 trace begin", 19) == 0){
+            inside = true;
+            pixel_lines = false;
+            dump.records.clear();
+            dump.pixel_data.clear();
+            continue;
+        }
+        if(!inside){
+            continue;
+        }
+        if(std::strncmp(line, "ILI9163 trace end", 17) == 0){
+            return true;
+        }
+
+        unsigned int start, end, kind, byte, count, value, data = 0, n;
+        if(std::sscanf(line, "ticks_per_us %u", &dump.ticks_per_us) == 1
+            || std::sscanf(line, "lost %u", &dump.lost) == 1
+            || std::strncmp(line, "records", 7) == 0){
+            continue;
+        }
+        if(std::sscanf(line, "pixel_data %u %u", &start, &n) == 2){
+            dump.pixel_first = start;
+            dump.pixel_data.reserve(n);
+            pixel_lines = true;
+            continue;
+        }
+        if(pixel_lines){
+            char * p = line;
+            char * next;
+            for(;;){
+                unsigned long pixel = std::strtoul(p, &next, 16);
+                if(next == p){
+                    break;
+                }
+                dump.pixel_data.push_back((uint16_t) pixel);
+                p = next;
+            }
+            continue;
+        }
+        // dumps without pixel data have no data column
+        if(std::sscanf(line, "%u %u %u %u %u %u %u", &start, &end, &kind, &byte, &count, &value, &data) >= 6){
+            dump.records.push_back(ILI9163_trace_record{
+                start, end, data, (uint16_t) count, (uint16_t) value, (ILI9163_trace_kind) kind, (uint8_t) byte });
+        }
+    }
+    return inside;
+}
+
+////////////////////////////////////////////////////////////////////////
+
+// the class a record is counted in: the kind, and for commands the command itself
+int record_class(const ILI9163_trace_record & r){
+    return r.kind == ILI9163_trace_kind::command ? 0x100 | r.byte : (int) r.kind;
+}
+
+void class_name(int c, char * name, size_t size){
+    static const char * const kinds[] = {
+        "?", "command", "parameter", "data16", "window", "pixels", "fill", "read", "list", "bytes" };
+    if(c & 0x100){
+        std::snprintf(name, size, "command 0x%02x", c & 0xff);
+    }else{
+        std::snprintf(name, size, "%s", c < 10 ? kinds[c] : "?");
+    }
+}
+
+struct class_time {
+    int c;
+    uint32_t count;
+    uint64_t ticks;
+};
+
+struct gap {
+    uint32_t ticks;
+    size_t after;
+};
+
+void report(const trace_dump & dump){
+    const auto & r = dump.records;
+    double tpu = dump.ticks_per_us;
+    if(r.empty()){
+        std::printf("no records\n");
+        return;
+    }
+
+    uint64_t busy = 0;
+    std::vector< class_time > classes;
+    std::vector< gap > gaps;
+    uint32_t windows = 0, small_windows = 0, empty_windows = 0;
+    uint64_t window_pixels = 0;
+    uint32_t pixels_in_window = 0;
+    bool in_window = false;
+
+    for(size_t i = 0; i < r.size(); i++){
+        uint32_t ticks = r[i].end - r[i].start;
+        busy += ticks;
+
+        int c = record_class(r[i]);
+        auto it = std::find_if(classes.begin(), classes.end(), [c](const class_time & t){ return t.c == c; });
+        if(it == classes.end()){
+            classes.push_back(class_time{ c, 0, 0 });
+            it = classes.end() - 1;
+        }
+        it->count++;
+        it->ticks += ticks;
+
+        if(i + 1 < r.size()){
+            gaps.push_back(gap{ r[i + 1].start - r[i].end, i });
+        }
+
+        // a window ends at the next window, or at a command that is not a write continue
+        bool ends = r[i].kind == ILI9163_trace_kind::window
+            || (r[i].kind == ILI9163_trace_kind::command && r[i].byte != 0x3c);
+        if(ends && in_window){
+            if(pixels_in_window == 0){
+                empty_windows++;
+            }else if(pixels_in_window < 16){
+                small_windows++;
+            }
+            window_pixels += pixels_in_window;
+            in_window = false;
+        }
+        if(r[i].kind == ILI9163_trace_kind::window){
+            windows++;
+            in_window = true;
+            pixels_in_window = 0;
+        }
+        if(r[i].kind == ILI9163_trace_kind::pixels || r[i].kind == ILI9163_trace_kind::fill){
+            pixels_in_window += r[i].count;
+        }
+        if(r[i].kind == ILI9163_trace_kind::data16){
+            pixels_in_window++;
+        }
+    }
+    if(in_window){
+        window_pixels += pixels_in_window;
+    }
+
+    uint32_t span = r.back().end - r.front().start;
+    std::printf("records  : %u, %u lost before the first\n", (unsigned) r.size(), dump.lost);
+    std::printf("span     : %.0f us, busy %.0f us (%.1f %%)\n", span / tpu, busy / tpu, span ? 100.0 * busy / span : 0.0);
+
+    std::sort(classes.begin(), classes.end(), [](const class_time & a, const class_time & b){ return a.ticks > b.ticks; });
+    std::printf("\n%-16s %8s %12s %10s %7s\n", "class", "count", "total us", "avg us", "busy");
+    for(const auto & t : classes){
+        char name[32];
+        class_name(t.c, name, sizeof(name));
+        std::printf("%-16s %8u %12.0f %10.2f %6.1f%%\n", name, t.count, t.ticks / tpu,
+            t.ticks / tpu / t.count, busy ? 100.0 * t.ticks / busy : 0.0);
+    }
+
+    std::printf("\nwindows  : %u, %.1f pixels per window\n", windows, windows ? (double) window_pixels / windows : 0.0);
+    std::printf("           %u with fewer than 16 pixels, %u without pixels\n", small_windows, empty_windows);
+
+    std::sort(gaps.begin(), gaps.end(), [](const gap & a, const gap & b){ return a.ticks > b.ticks; });
+    std::printf("\nlongest gaps between transfers:\n");
+    for(size_t i = 0; i < gaps.size() && i < 5; i++){
+        char before[32], after[32];
+        class_name(record_class(r[gaps[i].after]), before, sizeof(before));
+        class_name(record_class(r[gaps[i].after + 1]), after, sizeof(after));
+        std::printf("  %10.0f us after record %u (%s, before %s)\n", gaps[i].ticks / tpu, (unsigned) gaps[i].after, before, after);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////
+
+// the 130 x 129 pixels the driver uses, as a binary PPM
+bool save_frame(const trace_dump & dump, const char * file_name){
+    static ILI9163_simulator display;
+    unsigned int runs = 0, captured = 0;
+    for(const auto & r : dump.records){
+        const uint16_t * pixels = dump.pixels(r);
+        display.replay(r, pixels);
+        if(r.kind == ILI9163_trace_kind::pixels){
+            runs++;
+            captured += pixels != nullptr;
+        }
+    }
+    if(captured < runs){
+        std::printf("\n%u of %u pixel runs are not in the pixel data, they show their first colour\n", runs - captured, runs);
+    }
+
+    FILE * f = std::fopen(file_name, "wb");
+    if(f == nullptr){
+        return false;
+    }
+    std::fprintf(f, "P6\n130 129\n255\n");
+    for(int y = 0; y < 129; y++){
+        for(int x = 0; x < 130; x++){
+            // the driver sends blue in the high bits
+            uint16_t p = display.pixel(hwlib::xy(x, y));
+            uint8_t rgb[3] = { (uint8_t) ((p & 0x1f) << 3), (uint8_t) (((p >> 5) & 0x3f) << 2), (uint8_t) ((p >> 11) << 3) };
+            std::fwrite(rgb, 1, sizeof(rgb), f);
+        }
+    }
+    std::fclose(f);
+    return true;
+}
+
+// a simulated controller, with the bus a display talks to it through
+struct simulated_panel {
+    ILI9163_simulator chip;
+    ILI9163_simulator_bus bus;
+
+    simulated_panel():
+        bus( chip )
+    {}
+};
+
+// true when the graphics memory of a and b is the same, prints the first difference
+bool same_gram(const ILI9163_simulator & a, const ILI9163_simulator & b){
+    for(int y = 0; y < ILI9163_simulator::gram_size.y; y++){
+        for(int x = 0; x < ILI9163_simulator::gram_size.x; x++){
+            auto p = a.pixel(hwlib::xy(x, y));
+            auto q = b.pixel(hwlib::xy(x, y));
+            if(p != q){
+                std::printf("  first difference at %d, %d: %04x live, %04x replayed\n", x, y, p, q);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// play seed with the autopilot on window, flushing every tick, with a HUD from a display list on top
+void play_captured(hwlib::window & w, ILI9163_spi_res_wrx_cs & display, uint32_t seed, uint32_t ticks){
+    static uint8_t list_buffer[2048];
+    ILI9163_display_list hud(list_buffer, sizeof(list_buffer));
+    uint16_t bar[40];
+    for(int i = 0; i < 40; i++){
+        bar[i] = (uint16_t) (0x1111 * (i % 16));
+    }
+    hud.window(45, 1, 84, 3);
+    hud.pixels(bar, 40);
+    hud.pixels(bar, 40);
+    hud.pixels(bar, 40);
+
+    xorshift_random rnd(seed);
+    w.clear(hwlib::white);
+    game g(w, rnd);
+    autopilot player(g);
+    g.draw();
+    w.flush();
+    for(uint32_t i = 0; i < ticks && g.tick(player) == game_state::running; i++){
+        w.flush();
+        if(i % 50 == 0){
+            hud.replay(display);
+        }
+    }
+}
+
+// capture one game on a direct and one on a buffered display, replay both traces
+int check(){
+    static std::vector< ILI9163_trace_record > records(400000);
+    static std::vector< uint16_t > pixels(1 << 20);
+    ILI9163_trace trace(records.data(), records.size(), pixels.data(), pixels.size());
+    int failures = 0;
+
+    auto compare = [&](const char * name, const simulated_panel & live){
+        static ILI9163_simulator replayed;
+        replayed = ILI9163_simulator();
+        replayed.replay(trace);
+        bool ok = trace.overwritten() == 0 && same_gram(live.chip, replayed);
+        std::printf("%-9s %u records, %u pixels: %s\n", name, (unsigned) trace.size(),
+                    (unsigned) trace.pixel_position(), ok ? "ok" : "FAILED");
+        failures += !ok;
+    };
+
+    {
+        static simulated_panel live;
+        trace.clear();
+        ILI9163_display display(live.bus, hwlib::pin_out_dummy, live.bus.wrx(), hwlib::pin_out_dummy);
+        display.capture(&trace);
+        play_captured(display, display, 7, 3000);
+        compare("direct", live);
+    }
+    {
+        static simulated_panel live;
+        trace.clear();
+        static ILI9163_spi_128x128_buffered_res_wrx_cs display(live.bus, hwlib::pin_out_dummy, live.bus.wrx(), hwlib::pin_out_dummy);
+        display.capture(&trace);
+        play_captured(display, display, 7, 3000);
+        compare("buffered", live);
+    }
+    return failures;
+}
+
+int main(int argc, char * argv[]){
+    if(argc >= 2 && std::strcmp(argv[1], "check") == 0){
+        return check();
+    }
+    if(argc < 2){
+        std::fprintf(stderr, "usage: trace <dump-file> [frame.ppm] | trace check\n");
+        return 1;
+    }
+
+    FILE * f = std::fopen(argv[1], "r");
+    if(f == nullptr){
+        std::fprintf(stderr, "cannot read %s\n", argv[1]);
+        return 1;
+    }
+    trace_dump dump;
+    bool found = read_dump(f, dump);
+    std::fclose(f);
+    if(!found){
+        std::fprintf(stderr, "no trace in %s\n", argv[1]);
+        return 1;
+    }
+
+    report(dump);
+
+    if(argc >= 3){
+        if(!save_frame(dump, argv[2])){
+            std::fprintf(stderr, "cannot write %s\n", argv[2]);
+            return 1;
+        }
+        std::printf("\nframe saved to %s\n", argv[2]);
+    }
+    return 0;
+}